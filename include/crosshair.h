@@ -17,14 +17,15 @@
 
 #include "main.h"
 
+#include "oam.h"
+
 // A mini-module for drawing a crosshair sprite
 
-// returns the sprites it drew
-INLINE u32 crosshair_draw(u32 id, i32 xc, i32 yc) {
+INLINE void crosshair_draw(i32 xc, i32 yc) {
     const u32 distance = ((tick_count / 32) & 1) ? 1 : 3;
     const u32 tile = 53;
 
-    sprite_config(id++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = xc - distance - 8,
         .y = yc - distance - 8,
 
@@ -32,7 +33,7 @@ INLINE u32 crosshair_draw(u32 id, i32 xc, i32 yc) {
         .palette = 1
     });
 
-    sprite_config(id++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = xc + distance,
         .y = yc - distance - 8,
 
@@ -42,7 +43,7 @@ INLINE u32 crosshair_draw(u32 id, i32 xc, i32 yc) {
         .palette = 1
     });
 
-    sprite_config(id++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = xc - distance - 8,
         .y = yc + distance,
 
@@ -52,7 +53,7 @@ INLINE u32 crosshair_draw(u32 id, i32 xc, i32 yc) {
         .palette = 1
     });
 
-    sprite_config(id++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = xc + distance,
         .y = yc + distance,
 
@@ -61,6 +62,4 @@ INLINE u32 crosshair_draw(u32 id, i32 xc, i32 yc) {
         .tile = tile,
         .palette = 1
     });
-
-    return 4;
 }
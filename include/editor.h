@@ -24,4 +24,4 @@ extern i32 editor_yt;
 
 extern void editor_init(struct Level *level);
 extern void editor_tick(struct Level *level);
-extern void editor_draw(struct Level *level, u32 *used_sprites);
+extern void editor_draw(struct Level *level);
@@ -58,9 +58,10 @@ struct entity_Type {
 
     void (*tick)(struct Level *level, struct entity_Data *data);
 
-    // returns how many sprites were used
-    u32 (*draw)(struct Level *level, struct entity_Data *data,
-                i32 x, i32 y, u32 used_sprites);
+    // Requests the entity's sprites (see oam.h). This is called at the
+    // end of the level's tick, not while drawing.
+    void (*draw)(struct Level *level, struct entity_Data *data,
+                 i32 x, i32 y);
 
     // If defined, this is called when this entity (data) touches
     // another entity (touched_data) while trying to move.
@@ -0,0 +1,34 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// Background jobs use the time left between the end of a tick and the
+// next VBlank. A job runs in slices: each call of 'slice' must do a
+// small, bounded amount of work and return true if there is more to do.
+
+#define JOB_LIMIT 4
+
+// scanlines used by jobs in the last frame
+extern u32 job_used_lines;
+
+// Returns false if there are too many jobs.
+extern bool job_add(bool (*slice)(u32 data), u32 data);
+
+// Runs job slices until VBlank is near. Call this after the tick, only
+// if it ended in time.
+extern void job_run(void);
@@ -0,0 +1,35 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// The keypad is sampled in the VBlank interrupt and key presses are
+// queued, so that ticks see every press even if they run late. Each
+// tick takes the presses of one sample.
+//
+// With LATE_INPUT, presses are instead taken from the keys sampled by
+// 'input_update' at the start of the tick, which the main loop delays.
+
+// sample the keypad: call this in the VBlank interrupt (unless
+// LATE_INPUT is defined)
+extern void keypad_sample(void);
+
+// take the next queued presses: call this once per tick
+extern void keypad_update(void);
+
+// true if the key was pressed in the presses taken by 'keypad_update'
+extern bool keypad_press(u32 key);
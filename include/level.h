@@ -21,8 +21,8 @@
 #include "entity.h"
 
 // Level size (in tiles)
-#define LEVEL_W (16)
-#define LEVEL_H (16)
+#define LEVEL_W (64)
+#define LEVEL_H (64)
 #define LEVEL_SIZE (LEVEL_W * LEVEL_H)
 
 // Tile size: 3 = 8x8, 4 = 16x16, 5 = 32x32
@@ -38,8 +38,11 @@ typedef u8 level_EntityID;
 
 #define LEVEL_OBSTACLE_TYPES 3
 
+// maximum number of modified tiles redrawn one by one in a frame
+#define LEVEL_REDRAW_LIMIT (16)
+
 struct Level {
-    enum tile_TypeID tiles[LEVEL_SIZE];
+    u8 tiles[LEVEL_SIZE]; // enum tile_TypeID
     u8 data[LEVEL_SIZE];
 
     struct entity_Data entities[LEVEL_ENTITY_LIMIT];
@@ -52,6 +55,9 @@ struct Level {
     bool editing;
     u8 letters_to_deliver;
 
+    // keeps track of which tiles have been edited
+    bool tile_modified[LEVEL_SIZE];
+
     u32 attempts;
     bool should_reload;
 
@@ -61,41 +67,56 @@ struct Level {
         i32 y;
     } offset;
 
+    // point followed by the camera (the player's position)
+    struct {
+        i32 x;
+        i32 y;
+    } focus;
+
     bool shake;
     u8 shake_time;
+
+    // Modified tiles, redrawn together with their neighbors. If there
+    // are too many, the whole tilemap is redrawn.
+    struct {
+        u8 x;
+        u8 y;
+    } redraw[LEVEL_REDRAW_LIMIT];
+    u8 redraw_count;
+    bool redraw_all;
 };
 
 struct level_Metadata {
     const u8 *tile_data;
 
     struct {
-        u8 w : 4;
-        u8 h : 4;
+        u8 w;
+        u8 h;
     } size;
 
     struct {
-        u8 x : 4;
-        u8 y : 4;
+        u8 x;
+        u8 y;
     } spawn;
 
     u8 obstacles[LEVEL_OBSTACLE_TYPES];
 
     // list terminated by (0, 0)
     struct {
-        u8 x : 4;
-        u8 y : 4;
+        u8 x;
+        u8 y;
     } mailboxes[9];
 
     // list terminated by (0, 0)
     struct {
-        u8 x;
-        u8 y;
+        u16 x;
+        u16 y;
     } grass[8];
 
     // list terminated by (0, 0)
     struct {
-        u8 x : 4;
-        u8 y : 4;
+        u8 x;
+        u8 y;
 
         bool lower;
     } houses[9];
@@ -121,10 +142,23 @@ INLINE enum tile_TypeID level_get_tile(struct Level *level,
     return TILE_INVALID;
 }
 
+// Marks the tile at (x, y) to be redrawn, together with its neighbors.
+INLINE void level_redraw_tile(struct Level *level, i32 x, i32 y) {
+    if(level->redraw_count < LEVEL_REDRAW_LIMIT) {
+        level->redraw[level->redraw_count].x = x;
+        level->redraw[level->redraw_count].y = y;
+        level->redraw_count++;
+    } else {
+        level->redraw_all = true;
+    }
+}
+
 INLINE void level_set_tile(struct Level *level, i32 x, i32 y,
                            enum tile_TypeID id) {
-    if(x >= 0 && y >= 0 && x < LEVEL_W && y < LEVEL_H)
+    if(x >= 0 && y >= 0 && x < LEVEL_W && y < LEVEL_H) {
         level->tiles[x + y * LEVEL_W] = id;
+        level_redraw_tile(level, x, y);
+    }
 }
 
 INLINE u8 level_get_data(struct Level *level, i32 x, i32 y) {
@@ -134,8 +168,10 @@ INLINE u8 level_get_data(struct Level *level, i32 x, i32 y) {
 }
 
 INLINE void level_set_data(struct Level *level, i32 x, i32 y, u8 data) {
-    if(x >= 0 && y >= 0 && x < LEVEL_W && y < LEVEL_H)
+    if(x >= 0 && y >= 0 && x < LEVEL_W && y < LEVEL_H) {
         level->data[x + y * LEVEL_W] = data;
+        level_redraw_tile(level, x, y);
+    }
 }
 
 // === Entity functions ===
@@ -22,5 +22,16 @@
     #x ": wrong size, " #size " was expected" \
 )
 
+// If defined, each tick is delayed as much as possible and samples the
+// keypad when it starts, so that its effect is drawn sooner. This can
+// also be enabled by building with 'make LATE_INPUT=1'.
+//#define LATE_INPUT
+
+// number of scanlines in a frame, VBlank included
+#define SCANLINES 228
+
+// number of CPU cycles in a frame
+#define FRAME_CYCLES (SCANLINES * 1232)
+
 extern u32 tick_count;
 extern u32 levels_cleared;
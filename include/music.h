@@ -17,12 +17,33 @@
 
 #include "main.h"
 
-#define MUSIC_PLAY(sound) do {           \
-    audio_play(7, sound, sizeof(sound)); \
-    audio_loop(7, sizeof(sound));        \
-    audio_pitch(7, 0x1000);              \
+#include "sound.h"
+
+// Music is stored as 4-bit IMA ADPCM and decoded while it plays into a
+// ring buffer, which channel 7 loops over.
+struct music_Track {
+    const u8 *data; // two samples per byte, low nibble first
+    u32 samples;
+};
+
+// CPU cycles taken by the last music update
+extern u32 music_update_cycles;
+
+// measure the mixer's sample rate: call this after 'audio_init'
+extern void music_init(void);
+
+extern void music_play(const struct music_Track *track);
+
+// decode the samples read by the last audio update: call this right
+// after 'audio_update'
+extern void music_update(void);
+
+#define MUSIC_PLAY(track) do { \
+    SOUND_LOCK();              \
+    music_play(&(track));      \
+    SOUND_UNLOCK();            \
 } while(0)
 
-extern const u8 music_game[260624];
-extern const u8 music_map[130312];
-extern const u8 music_editing[130312];
+extern const struct music_Track music_game;
+extern const struct music_Track music_map;
+extern const struct music_Track music_editing;
@@ -0,0 +1,57 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// Sprites are requested with a priority class. If there are more
+// requests than available sprites, those of the lowest classes are
+// dropped. Accepted sprites keep the order in which they were
+// requested (i.e. earlier requests are drawn on top of later ones).
+//
+// Requests (and affine parameters) are only written into OAM by
+// 'oam_end', so they can be made outside of VBlank.
+
+enum oam_Class {
+    OAM_CLASS_UI,       // cursors, sidebar, tutorial bubbles
+    OAM_CLASS_GAMEPLAY, // player, mailboxes
+    OAM_CLASS_DECOR,    // houses, grass, letters
+    OAM_CLASS_PARTICLE, // purely cosmetic particles
+
+    OAM_CLASSES
+};
+
+// maximum number of requests in a frame
+#define OAM_REQUEST_LIMIT (SPRITE_COUNT + 64)
+
+// number of requests dropped in the last displayed frame
+extern u16 oam_dropped[OAM_CLASSES];
+
+// start collecting requests, using sprites from 'first_sprite' onward
+extern void oam_begin(u32 first_sprite);
+
+extern void oam_request(enum oam_Class class, const struct Sprite *sprite);
+
+// request 'count' sprites at once, e.g. from a cache
+extern void oam_request_block(enum oam_Class class,
+                              const struct Sprite *sprites, u32 count);
+
+// set the affine parameter 'id' (0-31)
+extern void oam_affine(u32 id, const i16 matrix[4]);
+
+// configure the accepted sprites, hide the unused ones and set the
+// requested affine parameters
+extern void oam_end(void);
@@ -17,6 +17,29 @@
 
 #include "main.h"
 
+// Called right after input is sampled, to measure input latency.
+extern void performance_input(void);
+
 extern void performance_tick(void);
+
+// Returns true if extra ticks should be run in the current frame. While
+// the performance overlay is on, holding L and R in the game scene
+// fast-forwards.
+extern bool performance_fast_forward(void);
 extern void performance_draw(void);
 extern void performance_vblank(void);
+
+// Called by the main loop before and after halting (waiting for VBlank
+// or, with LATE_INPUT, for the scanline at which the tick starts), to
+// measure how long the CPU is halted in each scene.
+extern void performance_wait_begin(void);
+extern void performance_wait_end(void);
+
+// Called by the main loop when a draw is skipped to catch up with a late
+// tick, and when ticks are dropped because the game is too far behind.
+extern void performance_late(void);
+extern void performance_dropped(u32 count);
+
+// Called when a scene transition starts and ends, to measure how much
+// CPU time the transition leaves idle.
+extern void performance_transition(bool active);
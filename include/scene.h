@@ -18,18 +18,64 @@
 #include "main.h"
 
 extern const struct Scene {
+    // Optional: heavy initialization work, split into steps. Runs the
+    // given step and returns true if there are more steps to run.
+    // Transitions run one step per frame before calling 'init', while
+    // the screen is dark.
+    bool (*prepare)(u32 data, u32 step);
+
     void (*init)(u32 data);
     void (*tick)(void);
     void (*draw)(void);
 } *scene;
 
+// Runs all the preparation steps of a scene, starting from 'step'.
+INLINE void scene_prepare(const struct Scene *new_scene, u32 data,
+                          u32 step) {
+    if(new_scene->prepare)
+        while(new_scene->prepare(data, step++));
+}
+
 INLINE void scene_set(const struct Scene *new_scene, u32 data) {
     scene = new_scene;
+    scene_prepare(scene, data, 0);
     scene->init(data);
 }
 
+// If defined, transitions freeze the previous scene on its last drawn
+// frame and only change the fade, leaving the CPU to the next scene's
+// preparation steps. This can also be enabled by building with
+// 'make FROZEN_TRANSITIONS=1'.
+//#define SCENE_FROZEN_TRANSITIONS
+
 extern void scene_transition_to(const struct Scene *next, u32 data);
 
+// Scenes keep their large state in the scene arena: only one scene is
+// live at a time, so they can all use the same memory. A scene owns the
+// arena from its first preparation step (or from 'init') until the next
+// scene starts preparing, so the arena's content is lost after a scene
+// change.
+#define SCENE_ARENA_SIZE (40 * 1024)
+extern u32 scene_arena[SCENE_ARENA_SIZE / sizeof(u32)];
+
+// Declares 'name' as a pointer to a state stored in the scene arena.
+#define SCENE_ARENA_STATE(type, name)\
+    static type *const name = (type *) scene_arena;\
+    static_assert(\
+        sizeof(type) <= SCENE_ARENA_SIZE,\
+        #type " does not fit in the scene arena"\
+    )
+
+// Defines the absolute symbol 'scene_footprint_<scene_name>' as the
+// size of a state stored in the scene arena, so that the build can
+// report it. This must be used inside a function.
+#define SCENE_ARENA_FOOTPRINT(scene_name, type)\
+    __asm__(\
+        ".global scene_footprint_" #scene_name "\n"\
+        ".set scene_footprint_" #scene_name ", %c0"\
+        : : "i" (sizeof(type))\
+    )
+
 // Scenes
 extern const struct Scene
     scene_prestart,
@@ -22,8 +22,23 @@
 #define BG2_TILEMAP display_screenblock(4)
 #define BG3_TILEMAP display_screenblock(6)
 
-#define SCREEN_FOG_PARTICLE_COUNT 10
+// If defined, fog is drawn on BG0 instead of using sprites. This can
+// also be enabled by building with 'make FOG_BACKGROUND=1'.
+//#define SCREEN_FOG_BACKGROUND
+
+#ifdef SCREEN_FOG_BACKGROUND
+    #define SCREEN_FOG_PARTICLE_COUNT 0
+
+    // First tile of the fog's tileset in charblock 2. The map's tileset
+    // is loaded in charblock 1 and must not reach this tile.
+    #define SCREEN_FOG_FIRST_TILE 0
+#else
+    #define SCREEN_FOG_PARTICLE_COUNT 10
+#endif
 
 extern void screen_init(void);
 
-extern void screen_draw_fog_particles(u32 first_sprite_id);
+// Draws the fog using sprites starting from 'first_sprite_id'. If
+// SCREEN_FOG_BACKGROUND is defined, no sprites are used and the
+// parameter is ignored.
+extern void screen_draw_fog(u32 first_sprite_id);
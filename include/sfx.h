@@ -17,11 +17,15 @@
 
 #include "main.h"
 
+#include "sound.h"
+
 #define SFX_PLAY(sound, pitch_variation) do {           \
-    i32 c = audio_play(-1, (sound), sizeof(sound));     \
     i32 p_range = 0x100 * (pitch_variation);            \
     i32 p = 0x1000 - p_range + random(2 * p_range + 1); \
+    SOUND_LOCK();                                       \
+    i32 c = audio_play(-1, (sound), sizeof(sound));     \
     if(c >= 0) audio_pitch(c, p);                       \
+    SOUND_UNLOCK();                                     \
 } while(0)
 
 extern const u8 sfx_delivery[4686];
@@ -0,0 +1,44 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// Audio is updated by a timer interrupt once per frame, at the end of
+// VBlank, so that long ticks do not delay it. Audio channels must only
+// be changed between SOUND_LOCK and SOUND_UNLOCK.
+
+#define SOUND_TIMER     TIMER3
+#define SOUND_TIMER_IRQ IRQ_TIMER3
+
+// A frame lasts 280896 cycles: exactly 4389 timer ticks with prescaler
+// 64, so the timer stays in phase with the display. Its counter goes
+// from 0x10000 - SOUND_FRAME_TICKS to 0xffff in every frame.
+#define SOUND_FRAME_TICKS 4389
+
+// Returns the number of timer ticks since the last audio update.
+INLINE u32 sound_timer_ticks(void) {
+    return timer_get_counter(SOUND_TIMER) - (0x10000 - SOUND_FRAME_TICKS);
+}
+
+#define SOUND_LOCK()   interrupt_toggle(SOUND_TIMER_IRQ, false)
+#define SOUND_UNLOCK() interrupt_toggle(SOUND_TIMER_IRQ, true)
+
+// CPU cycles taken by the last audio update
+extern u32 sound_update_cycles;
+
+// start updating audio: call this after 'audio_init'
+extern void sound_init(void);
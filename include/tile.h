@@ -48,3 +48,20 @@ INLINE const struct tile_Type *tile_get_type(enum tile_TypeID id) {
         return &tile_type_list[id];
     return NULL;
 }
+
+// The level's tilemaps hold a ring of TILE_RING_W x TILE_RING_H tiles:
+// tile (xt, yt) is drawn at (xt mod TILE_RING_W, yt mod TILE_RING_H).
+#define TILE_RING_W (32)
+#define TILE_RING_H (16)
+
+// Draws the tile at (xt, yt). Tiles never draw over their neighbors, so
+// each one can be redrawn on its own.
+extern void tile_draw(struct Level *level, i32 xt, i32 yt);
+
+// === Animation ===
+
+// palette used by holes, whose colors are cycled
+#define TILE_HOLE_PALETTE 3
+
+extern void tile_animation_init(void);
+extern void tile_animation_update(void);
@@ -0,0 +1,38 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// Copies to video memory (VRAM, OAM and palettes) can be queued and
+// done by DMA during VBlank. At most UPLOAD_BUDGET bytes are copied in
+// a frame: the rest is carried over to the next frames.
+
+#define UPLOAD_QUEUE_SIZE 32
+#define UPLOAD_BUDGET (8 * 1024)
+
+// copies left in the queue and bytes copied by the last flush
+extern u32 upload_queue_depth;
+extern u32 upload_flushed_bytes;
+
+// Queues a copy of 'bytes' bytes, done in chunks of DMA_CHUNK_16_BIT
+// or DMA_CHUNK_32_BIT. Returns false if the queue is full, or if 'bytes'
+// is not a multiple of the chunk size (the copy is not queued).
+extern bool upload_post(volatile void *dst, const volatile void *src,
+                        u32 bytes, u32 chunk);
+
+// do queued copies: call this during VBlank
+extern void upload_flush(void);
@@ -0,0 +1,42 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "main.h"
+
+// Sprite tiles from VRAM_FIRST_TILE onward are shared between assets
+// that are not always loaded. An asset stays resident after it is
+// released, so acquiring it again does not upload it.
+
+#define VRAM_FIRST_TILE 128
+#define VRAM_LAST_TILE  511
+
+// returned by 'vram_acquire' if there is no room for an asset
+#define VRAM_NO_TILE 0xffff
+
+// Returns the first sprite tile of 'src', an asset of 'tiles' 4bpp
+// tiles. If the asset is not resident, it is uploaded after the next
+// 'vram_update'. Every call should be matched by 'vram_release',
+// except those that return VRAM_NO_TILE: in that case, no reference is
+// taken and the asset must not be drawn.
+extern u16 vram_acquire(const void *src, u32 tiles);
+
+// releasing NULL or an asset that was not acquired does nothing
+extern void vram_release(const void *src);
+
+// Posts the uploads of newly acquired assets to the upload queue (see
+// upload.h). Call this during VBlank, before 'upload_flush'.
+extern void vram_update(void);
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+
+from sys import argv, exit
+from PIL import Image
+
+# usage: $0 <image> <palette> <palette-row> <output-file>
+#
+# Splits the image into 8x8 tiles and merges those that are identical,
+# or identical once flipped, into a shared 4bpp tileset. Writes the
+# tileset ('map_tileset') and a tilemap of screen entries ('map_tilemap')
+# using the given palette row.
+
+# a BG charblock holds 512 tiles of 4bpp
+CHARBLOCK_TILES = 512
+
+image   = Image.open(argv[1]).convert('RGBA')
+palette = Image.open(argv[2]).convert('RGBA')
+palette_row = int(argv[3])
+
+colors = {}
+for x in range(palette.width):
+    color = palette.getpixel((x, palette_row))
+    if color not in colors:
+        colors[color] = x
+
+w = image.width  // 8
+h = image.height // 8
+
+def read_tile(xt, yt):
+    tile = []
+    for y in range(8):
+        row = []
+        for x in range(8):
+            color = image.getpixel((xt * 8 + x, yt * 8 + y))
+            if color not in colors:
+                exit(f'{argv[1]}: color {color} is not in palette row '
+                     f'{palette_row}')
+            row.append(colors[color])
+        tile.append(tuple(row))
+    return tuple(tile)
+
+def flip(tile, hflip, vflip):
+    rows = [row[::-1] if hflip else row for row in tile]
+    return tuple(rows[::-1] if vflip else rows)
+
+tileset = []
+tile_ids = {} # tile -> (index, hflip, vflip)
+tilemap = []
+for yt in range(h):
+    for xt in range(w):
+        tile = read_tile(xt, yt)
+
+        if tile not in tile_ids:
+            # every flipped version refers to the same tileset entry
+            index = len(tileset)
+            tileset.append(tile)
+            for vflip in (False, True):
+                for hflip in (False, True):
+                    tile_ids.setdefault(
+                        flip(tile, hflip, vflip), (index, hflip, vflip)
+                    )
+
+        index, hflip, vflip = tile_ids[tile]
+        tilemap.append(index | hflip << 10 | vflip << 11 | palette_row << 12)
+
+unique  = len(tileset)
+before  = w * h * 32
+after   = unique * 32 + len(tilemap) * 2
+
+print(f'{argv[1]}: {unique} unique tiles out of {w * h}, '
+      f'{before} -> {after} bytes ({before - after} saved)')
+
+if unique > CHARBLOCK_TILES:
+    exit(f'{argv[1]}: {unique} unique tiles do not fit in a charblock '
+         f'({CHARBLOCK_TILES})')
+
+with open(argv[4], 'w') as f:
+    f.write(f'// generated by {argv[0]}\n\n')
+
+    f.write('#define MAP_TILESET_TILES ' + str(unique) + '\n\n')
+
+    f.write(f'static const u32 map_tileset[{unique * 8}] = {{\n')
+    for tile in tileset:
+        words = []
+        for row in tile:
+            word = 0
+            for x in range(8):
+                word |= row[x] << (x * 4)
+            words.append(f'0x{word:08x}')
+        f.write('    ' + ', '.join(words) + ',\n')
+    f.write('};\n\n')
+
+    f.write(f'static const u16 map_tilemap[{len(tilemap)}] = {{\n')
+    for i in range(0, len(tilemap), w):
+        row = tilemap[i:i + w]
+        for j in range(0, len(row), 12):
+            f.write('    ' + ', '.join(f'0x{e:04x}' for e in row[j:j + 12])
+                    + ',\n')
+    f.write('};\n')
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+from sys import argv
+
+# usage: $0 <input-file> <name> <output-file>
+#
+# Encodes raw signed 8-bit PCM as 4-bit IMA ADPCM (two samples per byte,
+# low nibble first) and writes it as a 'struct music_Track' called
+# <name>. The decoder keeps the top 8 bits of its 16-bit prediction, so
+# samples are encoded as the middle of the range that maps back to them.
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+    16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8] * 2
+
+def clip(x, low, high):
+    return max(low, min(x, high))
+
+class Decoder:
+    def __init__(self):
+        self.predictor = 0
+        self.index = 0
+
+    def decode(self, code):
+        step = STEP_TABLE[self.index]
+
+        diff = step >> 3
+        if code & 4: diff += step
+        if code & 2: diff += step >> 1
+        if code & 1: diff += step >> 2
+
+        if code & 8:
+            self.predictor -= diff
+        else:
+            self.predictor += diff
+        self.predictor = clip(self.predictor, -32768, 32767)
+
+        self.index = clip(self.index + INDEX_TABLE[code], 0, 88)
+        return self.predictor
+
+def encode(samples):
+    # the encoder follows the decoder's state, so errors do not add up
+    decoder = Decoder()
+    codes = []
+    for sample in samples:
+        step = STEP_TABLE[decoder.index]
+        diff = (sample << 8 | 0x80) - decoder.predictor
+
+        code = 0
+        if diff < 0:
+            code = 8
+            diff = -diff
+        if diff >= step:
+            code |= 4
+            diff -= step
+        if diff >= step >> 1:
+            code |= 2
+            diff -= step >> 1
+        if diff >= step >> 2:
+            code |= 1
+
+        decoder.decode(code)
+        codes.append(code)
+    return codes
+
+raw = open(argv[1], 'rb').read()
+samples = [b - 256 if b >= 128 else b for b in raw]
+
+codes = encode(samples)
+if len(codes) % 2 == 1:
+    codes.append(0)
+
+data = bytes(codes[i] | codes[i + 1] << 4 for i in range(0, len(codes), 2))
+
+print(f'{argv[1]}: {len(raw)} -> {len(data)} bytes '
+      f'({len(raw) - len(data)} saved)')
+
+name = argv[2]
+with open(argv[3], 'w') as f:
+    f.write(f'// generated by {argv[0]}\n\n')
+
+    f.write(f'static const u8 {name}_data[{len(data)}] = {{\n')
+    for i in range(0, len(data), 12):
+        f.write('    ' + ', '.join(f'0x{b:02x}' for b in data[i:i + 12])
+                + ',\n')
+    f.write('};\n\n')
+
+    f.write(f'const struct music_Track {name} = {{\n')
+    f.write(f'    .data = {name}_data,\n')
+    f.write(f'    .samples = {len(samples)}\n')
+    f.write('};\n')
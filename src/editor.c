@@ -19,6 +19,9 @@
 #include "tile.h"
 #include "entity.h"
 #include "crosshair.h"
+#include "keypad.h"
+#include "oam.h"
+#include "vram.h"
 #include "music.h"
 #include "sfx.h"
 
@@ -41,8 +44,7 @@ static struct {
     i32 step;
 } sidebar;
 
-// keeps track of which tiles have been edited
-static bool tile_modified[LEVEL_SIZE];
+static u16 sidebar_tile;
 
 static bool any_obstacle_left(void) {
     for(u32 i = 0; i < LEVEL_OBSTACLE_TYPES; i++)
@@ -96,15 +98,13 @@ void editor_init(struct Level *level) {
     sidebar.time = 0;
     sidebar.step = +1;
 
-    // load edit sidebar
-    memory_copy_32(
-        (vu8 *) display_charblock(4) + 128 * 32,
-        level_sidebar,
-        4 * 8 * 32
-    );
+    // load edit sidebar (the previous load's reference is released
+    // first, so that the sidebar is only uploaded once)
+    vram_release(level_sidebar);
+    sidebar_tile = vram_acquire(level_sidebar, 4 * 8);
 
     // clear 'tile_modified'
-    memory_clear(tile_modified, sizeof(tile_modified));
+    memory_clear(level->tile_modified, sizeof(level->tile_modified));
 
     // play music
     if(level->editing)
@@ -137,7 +137,7 @@ static inline bool try_to_place(struct Level *level) {
         1    << 0 | // platform
         flip << 1   // flip
     );
-    tile_modified[xt + yt * LEVEL_W] = true;
+    level->tile_modified[xt + yt * LEVEL_W] = true;
 
     if(obstacles[selected] == 0) {
         if(any_obstacle_left())
@@ -154,7 +154,7 @@ static inline bool try_to_place(struct Level *level) {
 static inline void remove_placed_obstacles(struct Level *level) {
     for(u32 yt = 0; yt < level->metadata->size.h; yt++) {
         for(u32 xt = 0; xt < level->metadata->size.w; xt++) {
-            if(!tile_modified[xt + yt * LEVEL_W])
+            if(!level->tile_modified[xt + yt * LEVEL_W])
                 continue;
 
             // add block particle
@@ -163,7 +163,7 @@ static inline void remove_placed_obstacles(struct Level *level) {
 
             // replace with platform tile
             level_set_tile(level, xt, yt, TILE_PLATFORM);
-            tile_modified[xt + yt * LEVEL_W] = false;
+            level->tile_modified[xt + yt * LEVEL_W] = false;
         }
     }
     reset_obstacles(level->metadata->obstacles);
@@ -206,7 +206,7 @@ static inline void animate_sidebar(struct Level *level) {
 IWRAM_SECTION
 void editor_tick(struct Level *level) {
     if(level->editing) {
-        if(input_press(KEY_SELECT))
+        if(keypad_press(KEY_SELECT))
             level->editing = false;
 
         // change selected obstacle if L or R pressed
@@ -216,10 +216,10 @@ void editor_tick(struct Level *level) {
         if(switch_step != 0)
             switch_item(switch_step);
 
-        if(input_press(KEY_A))
+        if(keypad_press(KEY_A))
             try_to_place(level);
 
-        if(input_press(KEY_B))
+        if(keypad_press(KEY_B))
             remove_placed_obstacles(level);
 
         move_cursor(level);
@@ -229,11 +229,11 @@ void editor_tick(struct Level *level) {
         animate_sidebar(level);
 }
 
-static inline void draw_cursor(struct Level *level, u32 *used_sprites) {
+static inline void draw_cursor(struct Level *level) {
     const i32 x = (editor_xt << LEVEL_TILE_SIZE) - level->offset.x + 8;
     const i32 y = (editor_yt << LEVEL_TILE_SIZE) - level->offset.y + 8;
 
-    sprite_config((*used_sprites)++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = x - 8,
         .y = y - 8,
 
@@ -244,10 +244,10 @@ static inline void draw_cursor(struct Level *level, u32 *used_sprites) {
         .palette = (selected == 0 ? 1 : 0)
     });
 
-    *used_sprites += crosshair_draw(*used_sprites, x, y);
+    crosshair_draw(x, y);
 }
 
-static inline void draw_sidebar(struct Level *level, u32 *used_sprites) {
+static inline void draw_sidebar(struct Level *level) {
     i32 t = sidebar.time * math_brad(120) / SIDEBAR_TIME_MAX;
 
     const i32 x = -32 + math_sin(t) * 48 / 0x4000;
@@ -261,7 +261,7 @@ static inline void draw_sidebar(struct Level *level, u32 *used_sprites) {
 
         // resource count
         if(count > 1) {
-            sprite_config((*used_sprites)++, &(struct Sprite) {
+            oam_request(OAM_CLASS_UI, &(struct Sprite) {
                 .x = x + 6,
                 .y = y + 13 + i * 16,
 
@@ -273,7 +273,7 @@ static inline void draw_sidebar(struct Level *level, u32 *used_sprites) {
         }
 
         // resource image
-        sprite_config((*used_sprites)++, &(struct Sprite) {
+        oam_request(OAM_CLASS_UI, &(struct Sprite) {
             .x = x + 8,
             .y = y + 8 + i * 16,
 
@@ -284,22 +284,24 @@ static inline void draw_sidebar(struct Level *level, u32 *used_sprites) {
         });
     }
 
-    // draw sidebar background
-    sprite_config((*used_sprites)++, &(struct Sprite) {
-        .x = x,
-        .y = y,
+    // draw sidebar background (unless there was no room for it)
+    if(sidebar_tile != VRAM_NO_TILE) {
+        oam_request(OAM_CLASS_UI, &(struct Sprite) {
+            .x = x,
+            .y = y,
 
-        .size = SPRITE_SIZE_32x64,
+            .size = SPRITE_SIZE_32x64,
 
-        .tile = 128,
-        .palette = 0
-    });
+            .tile = sidebar_tile,
+            .palette = 0
+        });
+    }
 }
 
 IWRAM_SECTION
-void editor_draw(struct Level *level, u32 *used_sprites) {
+void editor_draw(struct Level *level) {
     if(level->editing)
-        draw_cursor(level, used_sprites);
+        draw_cursor(level);
     if(sidebar.present)
-        draw_sidebar(level, used_sprites);
+        draw_sidebar(level);
 }
@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 
 struct grass_Data {
     u8 variant;
@@ -29,11 +30,11 @@ static void grass_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 grass_draw(struct Level *level, struct entity_Data *data,
-                      i32 x, i32 y, u32 used_sprites) {
+static void grass_draw(struct Level *level, struct entity_Data *data,
+                       i32 x, i32 y) {
     struct grass_Data *grass_data = (struct grass_Data *) &data->extra;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_DECOR, &(struct Sprite) {
         .x = x - 4,
         .y = y - 4,
 
@@ -42,8 +43,6 @@ static u32 grass_draw(struct Level *level, struct entity_Data *data,
         .tile = 48 + grass_data->variant,
         .palette = 1
     });
-
-    return 1;
 }
 
 const struct entity_Type entity_decor_grass = {
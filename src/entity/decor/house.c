@@ -16,21 +16,22 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 
 IWRAM_SECTION
 static void house_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 house_draw(struct Level *level, struct entity_Data *data,
-                      i32 x, i32 y, u32 used_sprites) {
+static void house_draw(struct Level *level, struct entity_Data *data,
+                       i32 x, i32 y) {
     i32 xt = data->x >> LEVEL_TILE_SIZE;
     i32 yt = data->y >> LEVEL_TILE_SIZE;
 
     if(level_get_tile(level, xt, yt) == TILE_HIGH_GROUND)
         y -= 4;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_DECOR, &(struct Sprite) {
         .x = x - 8,
         .y = y - 8 - 4,
 
@@ -39,8 +40,6 @@ static u32 house_draw(struct Level *level, struct entity_Data *data,
         .tile = 20,
         .palette = 1
     });
-
-    return 1;
 }
 
 const struct entity_Type entity_decor_house = {
@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 #include "sfx.h"
 
 #define ANIMATION_TIME 14
@@ -39,8 +40,8 @@ static void mailbox_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 mailbox_draw(struct Level *level, struct entity_Data *data,
-                        i32 x, i32 y, u32 used_sprites) {
+static void mailbox_draw(struct Level *level, struct entity_Data *data,
+                         i32 x, i32 y) {
     struct mailbox_Data *mailbox_data = (struct mailbox_Data *) &data->extra;
 
     const u32  animation   = mailbox_data->animation;
@@ -51,7 +52,7 @@ static u32 mailbox_draw(struct Level *level, struct entity_Data *data,
 
     // Note: sprites flipped using affine transformations are shifted by
     // one pixel horizontally, so (should_scale && flip) is subtracted.
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_GAMEPLAY, &(struct Sprite) {
         .x = x - 8 - 8 * should_scale - (should_scale && flip),
         .y = y - 20 - 16 * should_scale,
 
@@ -70,13 +71,11 @@ static u32 mailbox_draw(struct Level *level, struct entity_Data *data,
         const u32 t = animation * math_brad(180) / ANIMATION_TIME;
         const u32 scale_y = 0x4000 + math_sin(t);
 
-        sprite_affine(1, (i16 [4]) {
+        oam_affine(1, (i16 [4]) {
             256 * (flip ? -1 : +1), 0,
             0, 256 * 0x4000 / scale_y
         });
     }
-
-    return 1;
 }
 
 IWRAM_SECTION
@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 
 #define ANIMATION_PHASES 6
 
@@ -45,14 +46,14 @@ static void block_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 block_draw(struct Level *level, struct entity_Data *data,
-                      i32 x, i32 y, u32 used_sprites) {
+static void block_draw(struct Level *level, struct entity_Data *data,
+                       i32 x, i32 y) {
     struct particle_block_Data *particle_data =
         (struct particle_block_Data *) &data->extra;
 
     u32 phase = particle_data->phase;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_PARTICLE, &(struct Sprite) {
         .x = x - 4,
         .y = y - 4,
 
@@ -61,7 +62,6 @@ static u32 block_draw(struct Level *level, struct entity_Data *data,
         .tile = 64 + particle_data->spriteset * 8 + phase,
         .palette = (particle_data->spriteset == 0)
     });
-    return 1;
 }
 
 const struct entity_Type entity_particle_block = {
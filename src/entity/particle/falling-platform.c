@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 #include "sfx.h"
 
 #define LIFETIME 20
@@ -40,13 +41,13 @@ static void falling_platform_tick(struct Level *level,
 }
 
 IWRAM_SECTION
-static u32 falling_platform_draw(struct Level *level,
-                                 struct entity_Data *data,
-                                 i32 x, i32 y, u32 used_sprites) {
+static void falling_platform_draw(struct Level *level,
+                                  struct entity_Data *data,
+                                  i32 x, i32 y) {
     struct falling_platform_Data *platform_data =
         (struct falling_platform_Data *) &data->extra;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_PARTICLE, &(struct Sprite) {
         .x = x - 8,
         .y = y - 8,
 
@@ -60,12 +61,10 @@ static u32 falling_platform_draw(struct Level *level,
     });
 
     const u32 scale = 0x4000 - 0x3fff * platform_data->age / LIFETIME;
-    sprite_affine(platform_data->affine_parameter, (i16 [4]) {
+    oam_affine(platform_data->affine_parameter, (i16 [4]) {
         256 * 0x4000 / scale, 0,
         0, 256 * 0x4000 / scale
     });
-
-    return 1;
 }
 
 const struct entity_Type entity_particle_falling_platform = {
@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 
 #define SIZES 3
 
@@ -41,11 +42,11 @@ static void step_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 step_draw(struct Level *level, struct entity_Data *data,
-                     i32 x, i32 y, u32 used_sprites) {
+static void step_draw(struct Level *level, struct entity_Data *data,
+                      i32 x, i32 y) {
     struct step_Data *step_data = (struct step_Data *) &data->extra;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_PARTICLE, &(struct Sprite) {
         .x = x - 4,
         .y = y - 4,
 
@@ -54,7 +55,6 @@ static u32 step_draw(struct Level *level, struct entity_Data *data,
         .tile = 88 + step_data->size,
         .palette = 0
     });
-    return 1;
 }
 
 const struct entity_Type entity_particle_step = {
@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "level.h"
+#include "oam.h"
 #include "tile.h"
 
 #define EXPAND_TIME 16          // ticks bubble takes to expand
@@ -44,11 +45,11 @@ static void bubble_tick(struct Level *level, struct entity_Data *data) {
 }
 
 IWRAM_SECTION
-static u32 bubble_draw(struct Level *level, struct entity_Data *data,
-                       i32 x, i32 y, u32 used_sprites) {
+static void bubble_draw(struct Level *level, struct entity_Data *data,
+                        i32 x, i32 y) {
     struct bubble_Data *bubble_data = (struct bubble_Data *) &data->extra;
 
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_UI, &(struct Sprite) {
         .x = x - 8,
         .y = y - 24,
 
@@ -73,12 +74,10 @@ static u32 bubble_draw(struct Level *level, struct entity_Data *data,
         scale_y = 0x4000 - 0x3fff * shrink_age / SHRINK_TIME;
     }
 
-    sprite_affine(bubble_data->affine_parameter, (i16 [4]) {
+    oam_affine(bubble_data->affine_parameter, (i16 [4]) {
         256, 0,
         0, 256 * 0x4000 / scale_y
     });
-
-    return 1;
 }
 
 const struct entity_Type entity_particle_tutorial_bubble = {
@@ -17,6 +17,8 @@
 
 #include "level.h"
 #include "scene.h"
+#include "keypad.h"
+#include "oam.h"
 #include "sfx.h"
 
 #define   MAX_SPEED (1280)
@@ -134,16 +136,16 @@ static inline void handle_animation(struct Level *level,
 }
 
 static inline void read_input(i8 *xm, i8 *ym) {
-    if(input_press(KEY_UP)) {
+    if(keypad_press(KEY_UP)) {
         *xm = 0;
         *ym = -1;
-    } else if(input_press(KEY_LEFT)) {
+    } else if(keypad_press(KEY_LEFT)) {
         *xm = -1;
         *ym = 0;
-    } else if(input_press(KEY_DOWN)) {
+    } else if(keypad_press(KEY_DOWN)) {
         *xm = 0;
         *ym = +1;
-    } else if(input_press(KEY_RIGHT)) {
+    } else if(keypad_press(KEY_RIGHT)) {
         *xm = +1;
         *ym = 0;
     }
@@ -289,6 +291,10 @@ static void player_tick(struct Level *level, struct entity_Data *data) {
         return;
     }
 
+    // the camera follows the player
+    level->focus.x = data->x;
+    level->focus.y = data->y;
+
     // if the level is still in editing mode, do nothing
     if(level->editing)
         return;
@@ -366,16 +372,11 @@ static void player_tick(struct Level *level, struct entity_Data *data) {
 }
 
 // draw 'count' letters around the center (xc, yc)
-static inline u32 draw_letters(u32 count, i32 xc, i32 yc,
-                               u32 used_sprites) {
+static inline void draw_letters(u32 count, i32 xc, i32 yc) {
     // make sure that 'count' is less than the limit
     if(count > LETTERS_LIMIT)
         count = LETTERS_LIMIT;
 
-    // make sure that all sprites can be drawn
-    if(count > SPRITE_COUNT - used_sprites)
-        count = SPRITE_COUNT - used_sprites;
-
     for(u32 i = 0; i < count; i++) {
         // calculate target location
         u16 angle = letters[i].angle - tick_count * 256;
@@ -390,7 +391,7 @@ static inline u32 draw_letters(u32 count, i32 xc, i32 yc,
         letters[i].subx = (letters[i].subx * 7 + (target_x * 256)) / 8;
         letters[i].suby = (letters[i].suby * 7 + (target_y * 256)) / 8;
 
-        sprite_config(used_sprites++, &(struct Sprite) {
+        oam_request(OAM_CLASS_DECOR, &(struct Sprite) {
             .x = (letters[i].subx / 256) - 4,
             .y = (letters[i].suby / 256) - 4,
 
@@ -400,17 +401,16 @@ static inline u32 draw_letters(u32 count, i32 xc, i32 yc,
             .palette = 1
         });
     }
-    return count;
 }
 
 IWRAM_SECTION
-static u32 player_draw(struct Level *level, struct entity_Data *data,
-                       i32 x, i32 y, u32 used_sprites) {
+static void player_draw(struct Level *level, struct entity_Data *data,
+                        i32 x, i32 y) {
     struct player_Data *player_data = (struct player_Data *) &data->extra;
 
     // Note: sprites flipped using affine transformations are shifted by
     // one pixel horizontally, so player_data->sprite_flip is subtracted
-    sprite_config(used_sprites++, &(struct Sprite) {
+    oam_request(OAM_CLASS_GAMEPLAY, &(struct Sprite) {
         .x = x - 16 - player_data->sprite_flip,
         .y = y - 29,
 
@@ -443,16 +443,12 @@ static u32 player_draw(struct Level *level, struct entity_Data *data,
     if(player_data->sprite_flip)
         scale_x *= -1;
 
-    sprite_affine(0, (i16 [4]) {
+    oam_affine(0, (i16 [4]) {
         256 * 0x4000 / scale_x, 0,
         0, 256 * 0x4000 / scale_y
     });
 
-    const u32 letter_sprites = draw_letters(
-        level->letters_to_deliver, x, y, used_sprites
-    );
-
-    return 1 + letter_sprites;
+    draw_letters(level->letters_to_deliver, x, y);
 }
 
 const struct entity_Type entity_player = {
@@ -0,0 +1,71 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "job.h"
+
+// slices are not started after this scanline
+#define DEADLINE (DISPLAY_HEIGHT - 16)
+
+u32 job_used_lines;
+
+static struct {
+    bool (*slice)(u32 data);
+    u32 data;
+} jobs[JOB_LIMIT];
+
+static u32 job_count = 0;
+static u32 next_job = 0;
+
+bool job_add(bool (*slice)(u32 data), u32 data) {
+    if(job_count == JOB_LIMIT)
+        return false;
+
+    jobs[job_count].slice = slice;
+    jobs[job_count].data  = data;
+    job_count++;
+    return true;
+}
+
+static inline void remove_job(u32 i) {
+    job_count--;
+    jobs[i] = jobs[job_count];
+}
+
+void job_run(void) {
+    // If the tick ended during VBlank (after the draw), the whole next
+    // frame is left, up to the deadline.
+    const u32 start = display_vcount();
+    const bool started_in_vblank = (start >= DISPLAY_HEIGHT);
+
+    u32 vcount = start;
+    while(job_count > 0) {
+        if(vcount < DISPLAY_HEIGHT && vcount >= DEADLINE)
+            break;
+        if(!started_in_vblank && vcount >= DISPLAY_HEIGHT)
+            break;
+
+        // run jobs in turn
+        if(next_job >= job_count)
+            next_job = 0;
+
+        if(jobs[next_job].slice(jobs[next_job].data))
+            next_job++;
+        else
+            remove_job(next_job);
+
+        vcount = display_vcount();
+    }
+    job_used_lines = (vcount + SCANLINES - start) % SCANLINES;
+}
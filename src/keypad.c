@@ -0,0 +1,81 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "keypad.h"
+
+// The VBlank sample reads the key register itself: libsimplegba's
+// 'input_update' keeps the state read by 'input_press', which must only
+// change at the start of a tick.
+#define KEYINPUT (*(vu16 *) 0x04000130)
+
+// must be a power of 2
+#define QUEUE_SIZE 16
+
+// Single-producer single-consumer queue: only the VBlank interrupt
+// writes 'head' and only the main loop writes 'tail', so it can be
+// read without disabling interrupts. An entry is written before 'head'
+// is moved past it.
+static vu16 queue[QUEUE_SIZE];
+static vu32 head = 0;
+static vu32 tail = 0;
+
+static u16 last_keys = 0;
+static u16 presses = 0;
+
+// Return the keys pressed since the last read.
+static INLINE u16 read_presses(void) {
+    // keys are active low
+    const u16 keys = ~KEYINPUT & 0x3ff;
+    const u16 pressed = keys & ~last_keys;
+    last_keys = keys;
+
+    return pressed;
+}
+
+IWRAM_SECTION
+void keypad_sample(void) {
+    const u16 pressed = read_presses();
+    if(pressed == 0)
+        return;
+
+    // if the queue is full, drop the presses
+    const u32 next = (head + 1) % QUEUE_SIZE;
+    if(next == tail)
+        return;
+
+    queue[head] = pressed;
+    head = next;
+}
+
+void keypad_update(void) {
+    #ifdef LATE_INPUT
+    // the keys were just sampled by 'input_update'
+    presses = 0;
+    for(u32 key = 0; key < 10; key++)
+        if(input_press(key))
+            presses |= BIT(key);
+    #else
+    presses = 0;
+
+    if(tail != head) {
+        presses = queue[tail];
+        tail = (tail + 1) % QUEUE_SIZE;
+    }
+    #endif
+}
+
+bool keypad_press(u32 key) {
+    return presses & BIT(key);
+}
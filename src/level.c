@@ -20,9 +20,40 @@
 #include "tile.h"
 #include "editor.h"
 #include "music.h"
+#include "oam.h"
 
 #include "res/img/tutorial-text.c"
 
+#define SHAKE_TIME 15
+
+// lines the shake table is scrolled by every frame
+#define SHAKE_SCROLL 4
+
+// offset registers of BG2 and BG3 (horizontal and vertical)
+#define BG2_BG3_OFFSETS ((vu32 *) 0x04000018)
+
+// Per-scanline offsets of BG2 and BG3, copied by HBlank DMA while the
+// level is shaking. The first line of the screen keeps the offsets set
+// by 'background_offset' and the DMA writes those of the next lines.
+static u32 shake_table[DISPLAY_HEIGHT + 1 + SHAKE_TIME * SHAKE_SCROLL][2];
+
+// Tiles kept drawn in the tilemaps: those on the display, plus one more
+// on each side for shaking and one more below for the higher tiles.
+// The window must fit in the tilemaps' ring (see 'TILE_RING_W').
+#define WINDOW_W (DISPLAY_WIDTH  / 16 + 3)
+#define WINDOW_H (DISPLAY_HEIGHT / 16 + 3)
+
+// first tile of the window
+static i32 window_x;
+static i32 window_y;
+
+// tile below the editor cursor, drawn differently from the others
+static struct {
+    bool drawn;
+    i32 xt;
+    i32 yt;
+} cursor;
+
 static inline void insert_solid_entity(struct Level *level,
                                        struct entity_Data *data,
                                        level_EntityID id,
@@ -53,21 +84,52 @@ static inline void remove_solid_entity(struct Level *level,
         level->solid_entities[tile][data->solid_id] = LEVEL_NO_ENTITY;
 }
 
-static inline void update_offset(struct Level *level) {
+// Returns the offset that shows 'focus' at the center of the display,
+// without showing what is outside of the level. Levels smaller than the
+// display are centered instead.
+static inline i32 camera_target(i32 focus, i32 level_size,
+                                i32 display_size) {
+    if(level_size <= display_size)
+        return -(display_size - level_size) / 2;
+    return math_clip(focus - display_size / 2, 0, level_size - display_size);
+}
+
+static inline void update_offset(struct Level *level, bool snap) {
     const struct level_Metadata *metadata = level->metadata;
 
     const i32 width_pixels  = metadata->size.w << LEVEL_TILE_SIZE;
     const i32 height_pixels = metadata->size.h << LEVEL_TILE_SIZE;
 
-    level->offset.x = -(DISPLAY_WIDTH - width_pixels) / 2;
-    level->offset.y = -(DISPLAY_HEIGHT - height_pixels) / 2;
+    // while editing, follow the cursor instead of the player
+    i32 focus_x = level->focus.x;
+    i32 focus_y = level->focus.y;
+    if(level->editing) {
+        focus_x = (editor_xt << LEVEL_TILE_SIZE) + 8;
+        focus_y = (editor_yt << LEVEL_TILE_SIZE) + 8;
+    }
+
+    const i32 target_x = camera_target(focus_x, width_pixels,
+                                       DISPLAY_WIDTH);
+    const i32 target_y = camera_target(focus_y, height_pixels,
+                                       DISPLAY_HEIGHT);
+
+    if(snap) {
+        level->offset.x = target_x;
+        level->offset.y = target_y;
+    } else if(level->shake_time == 0) {
+        // Move by a quarter of the distance, rounded up. The camera does
+        // not move while shaking, as the shake table holds the offset.
+        const i32 dx = target_x - level->offset.x;
+        const i32 dy = target_y - level->offset.y;
+
+        level->offset.x += (dx + math_sign(dx) * 3) / 4;
+        level->offset.y += (dy + math_sign(dy) * 3) / 4;
+    }
 
-    // apply shaking effect
+    // update shaking effect
     if(level->shake_time > 0) {
         level->shake_time--;
 
-        level->offset.y += (-2 + random(4));
-
         // shake tutorial text
         background_mosaic(random(2), random(2));
     } else {
@@ -76,6 +138,31 @@ static inline void update_offset(struct Level *level) {
     }
 }
 
+static inline u32 bg_offset_value(i32 x, i32 y) {
+    return (x & 0x1ff) | (y & 0x1ff) << 16;
+}
+
+// Generate a table of horizontal wobble that fades out as the table
+// is scrolled, so that no work is needed while drawing.
+static inline void generate_shake_table(struct Level *level) {
+    const u32 lines = sizeof(shake_table) / sizeof(shake_table[0]);
+    const u16 phase = random(0x10000);
+
+    for(u32 i = 0; i < lines; i++) {
+        // amplitude goes from 2 to 0 pixels (256:1)
+        const i32 amplitude = (2 << 8) * (lines - i) / lines;
+        const i32 wobble = amplitude * math_sin(
+            phase + i * math_brad(360) / 32
+        ) / (0x4000 << 8);
+
+        const i32 x = level->offset.x + wobble;
+        const i32 y = level->offset.y;
+
+        shake_table[i][0] = bg_offset_value(x, y + 5); // BG2
+        shake_table[i][1] = bg_offset_value(x, y);     // BG3
+    }
+}
+
 static inline void tick_entities(struct Level *level) {
     for(u32 i = 0; i < LEVEL_ENTITY_LIMIT; i++) {
         struct entity_Data *data = &level->entities[i];
@@ -105,9 +192,36 @@ static inline void tick_entities(struct Level *level) {
     }
 }
 
+static inline void draw_entities(struct Level *level) {
+    for(level_EntityID id = 0; id < LEVEL_ENTITY_LIMIT; id++) {
+        struct entity_Data *data = &level->entities[id];
+        const struct entity_Type *type = entity_get_type(data);
+        if(!type)
+            continue;
+
+        const i32 draw_x = data->x - level->offset.x;
+        const i32 draw_y = data->y - level->offset.y;
+
+        // check if entity is out of display bounds
+        if(draw_x < -32 || draw_x >= DISPLAY_WIDTH + 32 ||
+           draw_y < -32 || draw_y >= DISPLAY_HEIGHT + 32)
+            continue;
+
+        type->draw(level, data, draw_x, draw_y);
+    }
+}
+
+// Sprites are requested at the end of the tick, so that drawing only
+// has to copy them into OAM.
+static inline void request_sprites(struct Level *level) {
+    oam_begin(SCREEN_FOG_PARTICLE_COUNT);
+    editor_draw(level);
+    draw_entities(level);
+}
+
 IWRAM_SECTION
 void level_tick(struct Level *level) {
-    update_offset(level);
+    update_offset(level, false);
 
     bool was_editing = level->editing;
     editor_tick(level);
@@ -118,64 +232,132 @@ void level_tick(struct Level *level) {
 
     // update shaking status
     if(level->shake) {
-        level->shake_time = 15;
+        level->shake_time = SHAKE_TIME;
         level->shake = false;
+
+        generate_shake_table(level);
     }
 
+    // 'level_load' requests sprites by itself
     if(level->should_reload)
         level_load(level, level->metadata);
+    else
+        request_sprites(level);
 }
 
-static inline void draw_tiles(struct Level *level) {
-    const struct level_Metadata *metadata = level->metadata;
+static inline bool in_window(i32 xt, i32 yt) {
+    return xt >= window_x && xt < window_x + WINDOW_W &&
+           yt >= window_y && yt < window_y + WINDOW_H;
+}
 
-    background_offset(BG2, level->offset.x, level->offset.y + 5);
-    background_offset(BG3, level->offset.x, level->offset.y);
+static inline void draw_column(struct Level *level, i32 xt) {
+    for(i32 yt = window_y; yt < window_y + WINDOW_H; yt++)
+        tile_draw(level, xt, yt);
+}
 
-    for(u32 y = 0; y < metadata->size.h; y++) {
-        for(u32 x = 0; x < metadata->size.w; x++) {
-            const struct tile_Type *type = tile_get_type(
-                level_get_tile(level, x, y)
-            );
-            if(!type || !type->draw)
-                continue;
+static inline void draw_row(struct Level *level, i32 yt) {
+    for(i32 xt = window_x; xt < window_x + WINDOW_W; xt++)
+        tile_draw(level, xt, yt);
+}
 
-            type->draw(level, x, y);
-        }
+// Moves the window so that it starts at (x0, y0). If it moved by a
+// single tile, only the column or row entering the window is drawn.
+static inline void move_window(struct Level *level, i32 x0, i32 y0) {
+    if(math_abs(x0 - window_x) > 1 || math_abs(y0 - window_y) > 1)
+        level->redraw_all = true;
+
+    if(level->redraw_all) {
+        window_x = x0;
+        window_y = y0;
+
+        for(i32 yt = window_y; yt < window_y + WINDOW_H; yt++)
+            draw_row(level, yt);
+        return;
+    }
+
+    if(x0 > window_x) {
+        window_x = x0;
+        draw_column(level, window_x + WINDOW_W - 1);
+    } else if(x0 < window_x) {
+        window_x = x0;
+        draw_column(level, window_x);
+    }
+
+    if(y0 > window_y) {
+        window_y = y0;
+        draw_row(level, window_y + WINDOW_H - 1);
+    } else if(y0 < window_y) {
+        window_y = y0;
+        draw_row(level, window_y);
     }
 }
 
-static inline void draw_entities(struct Level *level, u32 *used_sprites) {
-    for(level_EntityID id = 0; id < LEVEL_ENTITY_LIMIT; id++) {
-        struct entity_Data *data = &level->entities[id];
-        const struct entity_Type *type = entity_get_type(data);
-        if(!type)
-            continue;
+// A modified tile can change how its neighbors look (e.g. borders), so
+// they are redrawn as well.
+static inline void redraw_modified_tiles(struct Level *level) {
+    // if the whole window was redrawn, there is nothing left to do
+    for(u32 i = 0; i < level->redraw_count && !level->redraw_all; i++) {
+        const i32 xt = level->redraw[i].x;
+        const i32 yt = level->redraw[i].y;
+
+        for(i32 y = yt - 1; y <= yt + 1; y++)
+            for(i32 x = xt - 1; x <= xt + 1; x++)
+                if(in_window(x, y))
+                    tile_draw(level, x, y);
+    }
 
-        const i32 draw_x = data->x - level->offset.x;
-        const i32 draw_y = data->y - level->offset.y;
+    level->redraw_count = 0;
+    level->redraw_all = false;
+}
 
-        // check if entity is out of display bounds
-        if(draw_x < -32 || draw_x >= DISPLAY_WIDTH + 32 ||
-           draw_y < -32 || draw_y >= DISPLAY_HEIGHT + 32)
-            continue;
+static inline void redraw_cursor_tile(struct Level *level) {
+    // redraw the tile the cursor was on, in case it moved
+    if(cursor.drawn && in_window(cursor.xt, cursor.yt))
+        tile_draw(level, cursor.xt, cursor.yt);
 
-        *used_sprites += type->draw(
-            level, data, draw_x, draw_y, *used_sprites
-        );
-        if(*used_sprites >= SPRITE_COUNT)
-            break;
+    cursor.drawn = level->editing;
+    if(cursor.drawn) {
+        cursor.xt = editor_xt;
+        cursor.yt = editor_yt;
+
+        if(in_window(cursor.xt, cursor.yt))
+            tile_draw(level, cursor.xt, cursor.yt);
+    }
+}
+
+static inline void draw_tiles(struct Level *level) {
+    background_offset(BG2, level->offset.x, level->offset.y + 5);
+    background_offset(BG3, level->offset.x, level->offset.y);
+
+    if(level->shake_time > 0) {
+        const u32 first_line = (SHAKE_TIME - level->shake_time) *
+                               SHAKE_SCROLL;
+
+        // restart HBlank DMA from the current position in the table
+        dma_config(DMA0, &(struct DMA) {
+            .dest_control = DMA_ADDR_RELOAD,
+            .repeat = 1,
+            .chunk = DMA_CHUNK_32_BIT,
+            .start_timing = DMA_START_HBLANK
+        });
+        dma_transfer(DMA0, BG2_BG3_OFFSETS, shake_table[first_line + 1], 2);
     }
+
+    // Only the tiles around the display are kept drawn, so the cost
+    // does not depend on the level's size.
+    move_window(
+        level,
+        (level->offset.x >> LEVEL_TILE_SIZE) - 1,
+        (level->offset.y >> LEVEL_TILE_SIZE) - 1
+    );
+    redraw_modified_tiles(level);
+    redraw_cursor_tile(level);
 }
 
 IWRAM_SECTION
 void level_draw(struct Level *level) {
     const struct level_Metadata *metadata = level->metadata;
 
-    // clear the tilemap before redrawing
-    memory_clear_32(BG2_TILEMAP, 32 * 32 * 2);
-    memory_clear_32(BG3_TILEMAP, 32 * 32 * 2);
-
     // toggle tutorial text's background
     {
         bool show_tutorial_text = metadata->tutorial_text > 0;
@@ -189,20 +371,20 @@ void level_draw(struct Level *level) {
     }
 
     draw_tiles(level);
+    tile_animation_update();
 
-    u32 used_sprites = SCREEN_FOG_PARTICLE_COUNT;
-    editor_draw(level, &used_sprites);
-    draw_entities(level, &used_sprites);
-    sprite_hide_range(used_sprites, SPRITE_COUNT);
+    oam_end();
 }
 
 static inline void level_init(struct Level *level,
                               const struct level_Metadata *metadata) {
     level->metadata = metadata;
 
-    // clear 'data'
-    for(u32 i = 0; i < LEVEL_SIZE; i++)
+    // clear 'tiles' and 'data'
+    for(u32 i = 0; i < LEVEL_SIZE; i++) {
+        level->tiles[i] = TILE_VOID;
         level->data[i] = 0;
+    }
 
     // clear 'entities'
     for(u32 i = 0; i < LEVEL_ENTITY_LIMIT; i++)
@@ -214,6 +396,21 @@ static inline void level_init(struct Level *level,
             level->solid_entities[t][i] = LEVEL_NO_ENTITY;
 
     level->should_reload = false;
+
+    level->focus.x = (metadata->spawn.x << LEVEL_TILE_SIZE) + 8;
+    level->focus.y = (metadata->spawn.y << LEVEL_TILE_SIZE) + 8;
+
+    level->shake = false;
+    level->shake_time = 0;
+
+    level->redraw_count = 0;
+    level->redraw_all = true;
+
+    // The level is in the scene arena, so it holds what the previous
+    // scene left there. The other fields are set by 'level_load':
+    // 'letters_to_deliver' by load_mailboxes, 'editing' and
+    // 'tile_modified' by editor_init, 'offset' by update_offset.
+    // 'attempts' is set by the game scene before the first load.
 }
 
 static inline void load_tiles(struct Level *level) {
@@ -305,7 +502,6 @@ void level_load(struct Level *level,
     u32 old_seed = random_seed(256);
 
     level_init(level, metadata);
-    update_offset(level);
 
     load_tiles(level);
     load_mailboxes(level);
@@ -328,11 +524,16 @@ void level_load(struct Level *level,
     // initialize editor
     editor_init(level);
 
+    // the editor's cursor may be followed, so set the offset afterwards
+    update_offset(level, true);
+
     if(!level->editing && level->attempts == 0)
         MUSIC_PLAY(music_game);
 
     // restore pseudo-random seed
     random_seed(old_seed);
+
+    request_sprites(level);
 }
 
 IWRAM_SECTION
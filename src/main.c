@@ -16,9 +16,16 @@
 #include "main.h"
 
 #include "screen.h"
+#include "keypad.h"
 #include "performance.h"
 #include "scene.h"
 #include "storage.h"
+#include "tile.h"
+#include "vram.h"
+#include "upload.h"
+#include "job.h"
+#include "sound.h"
+#include "music.h"
 
 #include "res/CREDITS.c"
 
@@ -26,8 +33,9 @@ u32 tick_count = 0;
 u32 levels_cleared = 0;
 
 static inline void tick(void) {
-    audio_update();
     input_update();
+    keypad_update();
+    performance_input();
     scene->tick();
 
     performance_tick();
@@ -36,14 +44,112 @@ static inline void tick(void) {
 }
 
 static inline void draw(void) {
+    // fog is drawn first, so that scenes can override its blending
+    screen_draw_fog(0);
     scene->draw();
-    screen_draw_fog_particles(0);
+    vram_update();
+    upload_flush();
 
     performance_draw();
 }
 
+// Maximum number of frames a late tick can be caught up with. If the
+// game is further behind, the missed ticks are dropped.
+#define CATCH_UP_LIMIT 4
+
+// Maximum number of ticks run in a frame while fast-forwarding. Extra
+// ticks are not started after FAST_FORWARD_DEADLINE.
+#define FAST_FORWARD_LIMIT 8
+#define FAST_FORWARD_DEADLINE (DISPLAY_HEIGHT - 32)
+
+static vu32 vblank_count = 0;
+
+#ifdef LATE_INPUT
+// scanlines left free between the end of a tick and VBlank
+#define LATE_INPUT_MARGIN 16
+
+// length of the longest recent tick, in scanlines
+static u32 tick_lines = DISPLAY_HEIGHT;
+
+// one-shot timer that wakes the CPU when the tick should start
+#define WAKE_TIMER     TIMER2
+#define WAKE_TIMER_IRQ IRQ_TIMER2
+
+IWRAM_SECTION
+static void wake_isr(void) {
+    timer_stop(WAKE_TIMER);
+}
+
+static inline void late_input_init(void) {
+    timer_config(WAKE_TIMER, &(struct Timer) {
+        .prescaler = TIMER_PRESCALER_64,
+        .irq = true
+    });
+    interrupt_isr(WAKE_TIMER_IRQ, wake_isr);
+    interrupt_toggle(WAKE_TIMER_IRQ, true);
+}
+
+// Wait until the latest scanline at which the tick can start without
+// missing VBlank, based on how long recent ticks took. The CPU is
+// halted until the wake timer overflows at that scanline.
+static inline void wait_to_tick(void) {
+    const i32 start_line = DISPLAY_HEIGHT - LATE_INPUT_MARGIN -
+                           (i32) tick_lines;
+    if(start_line <= 0)
+        return;
+
+    const i32 vcount = display_vcount();
+    if(vcount < DISPLAY_HEIGHT && vcount >= start_line)
+        return;
+
+    // scanlines left until 'start_line' (a scanline is 1232 cycles)
+    const u32 lines = (start_line + SCANLINES - vcount) % SCANLINES;
+    timer_set_counter(WAKE_TIMER, 0x10000 - lines * 1232 / 64);
+    timer_start(WAKE_TIMER);
+
+    performance_wait_begin();
+    interrupt_wait(WAKE_TIMER_IRQ);
+    performance_wait_end();
+}
+
+// Update the length of the longest recent tick. It is slowly lowered,
+// so that one long tick does not keep input latency high.
+static inline void measure_tick(u32 start_vcount, bool late) {
+    const u32 lines = (display_vcount() + SCANLINES - start_vcount) %
+                      SCANLINES;
+
+    if(late)
+        tick_lines = DISPLAY_HEIGHT;
+    else if(lines >= tick_lines)
+        tick_lines = lines;
+    else
+        tick_lines--;
+}
+#endif
+
+// Returns true if there is time for another tick before 'vblank'. If
+// that VBlank has not started but the display is in VBlank, the tick
+// ended during the VBlank of the last draw.
+static inline bool has_time_left(u32 vblank) {
+    if(vblank_count + 1 != vblank)
+        return false;
+
+    const u32 vcount = display_vcount();
+    return vcount >= DISPLAY_HEIGHT || vcount < FAST_FORWARD_DEADLINE;
+}
+
 IWRAM_SECTION
 static void vblank(void) {
+    // The HBlank DMA that shakes the level is restarted by every level
+    // draw: stop it here, so that it never runs past the end of the
+    // table when a draw is skipped.
+    dma_stop(DMA0);
+
+    #ifndef LATE_INPUT
+    keypad_sample();
+    #endif
+
+    vblank_count++;
     performance_vblank();
 }
 
@@ -53,17 +159,66 @@ void AgbMain(void) {
 
     backup_init(BACKUP_SRAM);
     audio_init(AUDIO_MIXER);
+    music_init();
+    sound_init();
+    #ifdef LATE_INPUT
+    late_input_init();
+    #endif
     input_init(22, 4);
     screen_init();
+    tile_animation_init();
 
     scene_set(&scene_prestart, 0);
 
     storage_load();
 
+    // Each tick is meant for a VBlank: if it ends after its VBlank has
+    // passed, the draw is skipped and the next tick runs right away, so
+    // that the game catches up instead of slowing down.
+    u32 next_vblank = vblank_count + 1;
     while(true) {
+        #ifdef LATE_INPUT
+        // when catching up, tick right away
+        const bool on_time = (vblank_count + 1 == next_vblank);
+        if(on_time)
+            wait_to_tick();
+
+        const u32 start_vcount = display_vcount();
+        #endif
+
         tick();
 
-        interrupt_wait(IRQ_VBLANK);
-        draw();
+        const u32 vblank = next_vblank++; // VBlank the tick is meant for
+        const u32 missed = vblank_count + 1 - vblank;
+
+        #ifdef LATE_INPUT
+        if(on_time)
+            measure_tick(start_vcount, missed > 0);
+        #endif
+
+        if(missed == 0) {
+            // fast-forward: run more ticks while there is time left
+            if(performance_fast_forward()) {
+                for(u32 i = 1; i < FAST_FORWARD_LIMIT; i++) {
+                    if(!has_time_left(vblank))
+                        break;
+                    tick();
+                }
+            }
+
+            job_run();
+
+            performance_wait_begin();
+            interrupt_wait(IRQ_VBLANK);
+            performance_wait_end();
+
+            draw();
+        } else if(missed <= CATCH_UP_LIMIT) {
+            performance_late();
+        } else {
+            // too far behind: skip the ticks of the missed VBlanks
+            performance_dropped(missed - 1);
+            next_vblank = vblank_count + 1;
+        }
     }
 }
@@ -15,6 +15,158 @@
  */
 #include "music.h"
 
+// DMA sound plays one mixer sample every time the mixer's timer
+// overflows. That timer is assumed to be Timer 0 with prescaler 1: its
+// period, in CPU cycles, is measured once at startup.
+#define MIXER_TIMER TIMER0
+
+// period used if the mixer's timer does not seem to run (16384 Hz)
+#define DEFAULT_PERIOD 1024
+
+// The mixer loops over this ring buffer without being restarted, and
+// may read ahead of what is being played. The decoder keeps the buffer
+// full up to GUARD samples before the samples being played, so it only
+// replaces samples that the mixer has already read.
+#define BUFFER_SIZE 2048
+#define GUARD 64
+
+static const u16 step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+    16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const i8 index_table[8] = {
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+EWRAM_BSS_SECTION
+static i8 buffer[BUFFER_SIZE] ALIGNED(4);
+
+static u32 mixer_period; // in CPU cycles
+
+static const struct music_Track *track;
+static u32 position; // next sample of the track to decode
+
+// Samples played and decoded since the track started. Cycles that do
+// not make a whole sample yet are kept in 'played_cycles' (it starts
+// negative, as the track starts in the middle of a frame).
+static u32 played;
+static u32 decoded;
+static i32 played_cycles;
+
+// decoder state
+static i32 predictor;
+static i32 step_index;
+
+u32 music_update_cycles;
+
+IWRAM_SECTION
+static void decode(u32 count) {
+    const u8 *data = track->data;
+
+    for(u32 i = 0; i < count; i++) {
+        // loop back to the start of the track
+        if(position == track->samples) {
+            position = 0;
+            predictor = 0;
+            step_index = 0;
+        }
+
+        const u32 code = (data[position / 2] >> (position % 2 * 4)) & 0xf;
+        position++;
+
+        const i32 step = step_table[step_index];
+
+        i32 diff = step >> 3;
+        if(code & 4) diff += step;
+        if(code & 2) diff += step >> 1;
+        if(code & 1) diff += step >> 2;
+
+        if(code & 8)
+            predictor = math_max(predictor - diff, -32768);
+        else
+            predictor = math_min(predictor + diff, 32767);
+
+        step_index = math_clip(step_index + index_table[code & 7], 0, 88);
+
+        buffer[decoded % BUFFER_SIZE] = predictor >> 8;
+        decoded++;
+    }
+}
+
+// Measure the period of the mixer's timer. The counter restarts from
+// the reload value after each overflow, so the lowest value read right
+// after an overflow is the reload value. Reads are delayed by a varying
+// number of cycles, so that one of them falls on the overflow.
+static u32 measure_mixer_period(void) {
+    u16 lowest = 0xffff;
+    u32 overflows = 0;
+
+    u16 last = timer_get_counter(MIXER_TIMER);
+    for(u32 i = 0; i < 0x10000 && overflows < 256; i++) {
+        for(vu32 delay = random(16); delay > 0; delay--);
+
+        const u16 counter = timer_get_counter(MIXER_TIMER);
+        if(counter < last) {
+            overflows++;
+            if(counter < lowest)
+                lowest = counter;
+        }
+        last = counter;
+    }
+
+    if(overflows == 0)
+        return DEFAULT_PERIOD;
+    return 0x10000 - lowest;
+}
+
+void music_init(void) {
+    mixer_period = measure_mixer_period();
+}
+
+void music_play(const struct music_Track *music) {
+    track = music;
+
+    position = 0;
+    predictor = 0;
+    step_index = 0;
+
+    // the first update comes after the rest of the frame
+    played = 0;
+    decoded = 0;
+    played_cycles = -(i32) (sound_timer_ticks() * 64);
+
+    decode(BUFFER_SIZE - GUARD);
+
+    audio_play(7, buffer, BUFFER_SIZE);
+    audio_loop(7, BUFFER_SIZE);
+    audio_pitch(7, 0x1000);
+}
+
+IWRAM_SECTION
+void music_update(void) {
+    if(!track)
+        return;
+
+    const u16 start = timer_get_counter(SOUND_TIMER);
+
+    // count the samples played in the last frame
+    const u32 cycles = played_cycles + FRAME_CYCLES;
+    played += cycles / mixer_period;
+    played_cycles = cycles % mixer_period;
+
+    // replace the samples that the mixer has read
+    decode(played + BUFFER_SIZE - GUARD - decoded);
+
+    const u16 end = timer_get_counter(SOUND_TIMER);
+    music_update_cycles = (u16) (end - start) * 64;
+}
+
 #include "res/music/game.c"
 #include "res/music/map.c"
 #include "res/music/editing.c"
@@ -0,0 +1,148 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "oam.h"
+
+u16 oam_dropped[OAM_CLASSES];
+
+static u32 first;
+
+static u32 request_count;
+static struct Sprite requests[OAM_REQUEST_LIMIT];
+static u8 request_classes[OAM_REQUEST_LIMIT];
+
+// number of requests of each class in the current frame
+static u16 class_requests[OAM_CLASSES];
+
+// requests dropped because the request list was full
+static u16 overflow_dropped[OAM_CLASSES];
+
+static i16 affine_matrices[32][4];
+static u32 affine_changed; // bitmask
+
+void oam_begin(u32 first_sprite) {
+    first = first_sprite;
+    request_count = 0;
+
+    for(u32 c = 0; c < OAM_CLASSES; c++) {
+        class_requests[c] = 0;
+        overflow_dropped[c] = 0;
+    }
+}
+
+// If the request list is full, remove the last request of the lowest
+// class below 'class' (the one 'oam_end' would drop first). Returns
+// false if there is no room for a request of 'class'.
+static bool make_room(enum oam_Class class) {
+    if(request_count < OAM_REQUEST_LIMIT)
+        return true;
+
+    u32 lowest = OAM_CLASSES - 1;
+    while(lowest > class && class_requests[lowest] == 0)
+        lowest--;
+    if(lowest == class)
+        return false;
+
+    u32 i = request_count - 1;
+    while(request_classes[i] != lowest)
+        i--;
+
+    // keep the order of the other requests
+    for(; i < request_count - 1; i++) {
+        requests[i] = requests[i + 1];
+        request_classes[i] = request_classes[i + 1];
+    }
+    request_count--;
+
+    class_requests[lowest]--;
+    overflow_dropped[lowest]++;
+    return true;
+}
+
+IWRAM_SECTION
+void oam_request(enum oam_Class class, const struct Sprite *sprite) {
+    if(!make_room(class)) {
+        overflow_dropped[class]++;
+        return;
+    }
+
+    requests[request_count] = *sprite;
+    request_classes[request_count] = class;
+    request_count++;
+
+    class_requests[class]++;
+}
+
+IWRAM_SECTION
+void oam_request_block(enum oam_Class class,
+                       const struct Sprite *sprites, u32 count) {
+    const u32 n = math_min(count, OAM_REQUEST_LIMIT - request_count);
+
+    for(u32 i = 0; i < n; i++) {
+        requests[request_count + i] = sprites[i];
+        request_classes[request_count + i] = class;
+    }
+    request_count += n;
+    class_requests[class] += n;
+
+    // the list is full: the rest can only replace lower classes
+    for(u32 i = n; i < count; i++)
+        oam_request(class, &sprites[i]);
+}
+
+IWRAM_SECTION
+void oam_affine(u32 id, const i16 matrix[4]) {
+    for(u32 i = 0; i < 4; i++)
+        affine_matrices[id][i] = matrix[i];
+    affine_changed |= BIT(id);
+}
+
+IWRAM_SECTION
+void oam_end(void) {
+    // decide how many requests of each class are accepted, starting
+    // from the highest class
+    u16 accepted[OAM_CLASSES];
+
+    u32 available = SPRITE_COUNT - first;
+    for(u32 c = 0; c < OAM_CLASSES; c++) {
+        accepted[c] = math_min(class_requests[c], available);
+        available -= accepted[c];
+
+        // set, not added: the counts are those of the displayed frame,
+        // even if more ticks ran before it
+        oam_dropped[c] = overflow_dropped[c] +
+                         class_requests[c] - accepted[c];
+    }
+
+    // configure sprites in request order
+    u32 id = first;
+    for(u32 i = 0; i < request_count; i++) {
+        const u32 class = request_classes[i];
+        if(accepted[class] == 0)
+            continue;
+        accepted[class]--;
+
+        sprite_config(id++, &requests[i]);
+    }
+    sprite_hide_range(id, SPRITE_COUNT);
+
+    // set affine parameters
+    for(u32 i = 0; affine_changed != 0; i++) {
+        if(affine_changed & BIT(i)) {
+            sprite_affine(i, affine_matrices[i]);
+            affine_changed &= ~BIT(i);
+        }
+    }
+}
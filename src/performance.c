@@ -15,6 +15,13 @@
  */
 #include "performance.h"
 
+#include "scene.h"
+#include "oam.h"
+#include "upload.h"
+#include "job.h"
+#include "sound.h"
+#include "music.h"
+
 //#define PRINT_TO_MGBA
 
 static u16 tick_vcount;
@@ -23,22 +30,190 @@ static u16 draw_vcount;
 static u16 ticks = 0, frames = 0;
 static u16 tps   = 0, fps    = 0;
 
+// ticks since the last draw and the most in a frame in the last second
+static u16 frame_ticks = 0;
+static u16 max_frame_ticks = 0, max_frame_ticks_per_second = 0;
+
+// late frames (draws skipped) and dropped ticks in the last second
+static u16 late = 0, dropped = 0;
+static u16 late_per_second = 0, dropped_per_second = 0;
+
 static bool show_performance = false;
 static bool should_refresh = false;
 
+static vu32 vblank_total = 0; // VBlanks since power on
+
+// time at which input was last sampled, in scanlines
+static u32 input_time;
+
+// sum of input latencies in the last second, in scanlines
+static u32 latency_sum = 0, latency_count = 0;
+
+// true if a tick was late or dropped since the last draw
+static bool skipped_draw = false;
+static u32 latency = 0; // average, in hundredths of frame
+
+// most CPU cycles taken by an audio update in the last second
+static u32 max_sound_cycles = 0, max_sound_cycles_per_second = 0;
+
+// most CPU cycles taken by a music update in the last second
+static u32 max_music_cycles = 0, max_music_cycles_per_second = 0;
+
+// Frames a tick is stalled for when L+R+B is pressed in the map scene,
+// to check that audio keeps playing when the game runs late. This is a
+// debug-only busy-wait: it is reachable only with the overlay on.
+#define STALL_FRAMES 5
+
+#define SCENE_STATS_LIMIT 8
+
+// CPU cycles spent halted while waiting for VBlank, in each scene
+static struct {
+    const struct Scene *scene;
+
+    u32 frames;
+    u64 idle_cycles;
+    u32 min_idle_cycles; // worst frame
+} scene_stats[SCENE_STATS_LIMIT];
+static u32 scene_stats_count = 0;
+
+static u32 wait_start; // in sound timer ticks
+static u32 frame_idle; // cycles halted since the last draw
+
+static bool in_transition = false;
+static u32 transition_frames;
+static u32 transition_idle; // in scanlines
+
+// Return the number of scanlines left between the end of the tick and
+// the next VBlank. If the tick ended in the same VBlank as the draw,
+// the whole frame was left; if it ran past VBlank, nothing was.
+static inline u32 idle_scanlines(void) {
+    if(tick_vcount < DISPLAY_HEIGHT)
+        return DISPLAY_HEIGHT - tick_vcount;
+    if(tick_vcount >= draw_vcount)
+        return DISPLAY_HEIGHT + (SCANLINES - tick_vcount);
+    return 0;
+}
+
+void performance_wait_begin(void) {
+    wait_start = sound_timer_ticks();
+}
+
+// Idle time is read from the sound timer, so it is counted in steps of
+// 64 cycles. The timer wraps once per frame: a halt is assumed to last
+// less than a frame, or the time in excess is lost.
+void performance_wait_end(void) {
+    const u32 ticks = (sound_timer_ticks() + SOUND_FRAME_TICKS - wait_start) %
+                      SOUND_FRAME_TICKS;
+    frame_idle += ticks * 64;
+}
+
+// Add the cycles halted before a draw to the current scene's stats.
+static inline void record_idle(void) {
+    const u32 idle = frame_idle;
+    frame_idle = 0;
+
+    // find the current scene's stats, or add them
+    u32 i = 0;
+    while(i < scene_stats_count && scene_stats[i].scene != scene)
+        i++;
+
+    if(i == scene_stats_count) {
+        if(scene_stats_count == SCENE_STATS_LIMIT)
+            return;
+        scene_stats_count++;
+
+        scene_stats[i].scene = scene;
+        scene_stats[i].frames = 0;
+        scene_stats[i].idle_cycles = 0;
+        scene_stats[i].min_idle_cycles = FRAME_CYCLES;
+    }
+
+    scene_stats[i].frames++;
+    scene_stats[i].idle_cycles += idle;
+    if(idle < scene_stats[i].min_idle_cycles)
+        scene_stats[i].min_idle_cycles = idle;
+}
+
+#ifdef PRINT_TO_MGBA
+static const char *scene_name(const struct Scene *s) {
+    if(s == &scene_prestart) return "prestart";
+    if(s == &scene_start)    return "start";
+    if(s == &scene_map)      return "map";
+    if(s == &scene_game)     return "game";
+    return "transition";
+}
+#endif
+
+// Return the number of scanlines elapsed since power on.
+static inline u32 scanline_time(void) {
+    u32 vblanks, vcount;
+    do {
+        vblanks = vblank_total;
+        vcount = display_vcount();
+    } while(vblanks != vblank_total);
+
+    // lines are counted from the start of VBlank
+    return vblanks * SCANLINES +
+           (vcount + SCANLINES - DISPLAY_HEIGHT) % SCANLINES;
+}
+
+void performance_input(void) {
+    #ifdef LATE_INPUT
+    // the keypad is sampled now, at the start of the tick
+    input_time = scanline_time();
+    #else
+    // presses were sampled at the start of the last VBlank (or earlier,
+    // if the keypad queue is behind)
+    input_time = vblank_total * SCANLINES;
+    #endif
+}
+
 void performance_tick(void) {
     tick_vcount = display_vcount();
     ticks++;
 
+    frame_ticks++;
+    if(frame_ticks > max_frame_ticks)
+        max_frame_ticks = frame_ticks;
+
+    if(in_transition) {
+        transition_frames++;
+        transition_idle += idle_scanlines();
+    }
+
     if(input_down(KEY_L) && input_down(KEY_R) &&
        input_press(KEY_SELECT)) {
         show_performance = !show_performance;
     }
+
+    // The map scene does not fast-forward and ignores B, so the stall
+    // does not affect anything else.
+    if(show_performance && scene == &scene_map &&
+       input_down(KEY_L) && input_down(KEY_R) && input_press(KEY_B)) {
+        const u32 stall_end = vblank_total + STALL_FRAMES;
+        while(vblank_total < stall_end);
+    }
 }
 
 void performance_draw(void) {
     draw_vcount = display_vcount();
     frames++;
+    frame_ticks = 0;
+
+    record_idle();
+
+    // The frame drawn in this VBlank is displayed after it: take the
+    // middle of the display as the time the input becomes visible.
+    // Draws that follow late ticks are not counted, so that only the
+    // latency of on-time frames is averaged.
+    if(!skipped_draw) {
+        const u32 display_time = vblank_total * SCANLINES +
+                                 (SCANLINES - DISPLAY_HEIGHT) +
+                                 DISPLAY_HEIGHT / 2;
+        latency_sum += display_time - input_time;
+        latency_count++;
+    }
+    skipped_draw = false;
 
     if(!should_refresh)
         return;
@@ -50,11 +225,96 @@ void performance_draw(void) {
         "tps %u - fps %u - tick_vcount %x - draw_vcount %x",
         tps, fps, tick_vcount, draw_vcount
     );
+    mgba_printf(
+        "dropped sprites: ui %u - gameplay %u - decor %u - particle %u",
+        oam_dropped[OAM_CLASS_UI],    oam_dropped[OAM_CLASS_GAMEPLAY],
+        oam_dropped[OAM_CLASS_DECOR], oam_dropped[OAM_CLASS_PARTICLE]
+    );
+    mgba_printf(
+        "upload queue depth %u - uploaded bytes %u",
+        upload_queue_depth, upload_flushed_bytes
+    );
+    mgba_printf(
+        "late frames %u - dropped ticks %u",
+        late_per_second, dropped_per_second
+    );
+    mgba_printf(
+        "input latency %u.%02u frames", latency / 100, latency % 100
+    );
+    mgba_printf("job scanlines %u", job_used_lines);
+    for(u32 i = 0; i < scene_stats_count; i++) {
+        const u32 average = scene_stats[i].idle_cycles /
+                            scene_stats[i].frames;
+        mgba_printf(
+            "%s: idle %u%% on average - %u%% in the worst frame",
+            scene_name(scene_stats[i].scene),
+            average * 100 / FRAME_CYCLES,
+            scene_stats[i].min_idle_cycles * 100 / FRAME_CYCLES
+        );
+    }
+    mgba_printf("most ticks in a frame %u", max_frame_ticks_per_second);
+    mgba_printf(
+        "audio update max cycles %u", max_sound_cycles_per_second
+    );
+    mgba_printf(
+        "music update max cycles %u", max_music_cycles_per_second
+    );
+    #endif
+}
+
+bool performance_fast_forward(void) {
+    return show_performance && scene == &scene_game &&
+           input_down(KEY_L) && input_down(KEY_R);
+}
+
+void performance_late(void) {
+    late++;
+
+    skipped_draw = true;
+    frame_idle = 0;
+}
+
+void performance_dropped(u32 count) {
+    dropped += count;
+
+    skipped_draw = true;
+    frame_idle = 0;
+}
+
+void performance_transition(bool active) {
+    #ifdef PRINT_TO_MGBA
+    if(!active && show_performance) {
+        // say which mode the build uses, so that the idle time of
+        // normal and frozen transitions can be compared
+        #ifdef SCENE_FROZEN_TRANSITIONS
+        const char *mode = "frozen";
+        #else
+        const char *mode = "normal";
+        #endif
+
+        mgba_open();
+        mgba_printf(
+            "%s transition: %u frames - idle %u%%",
+            mode, transition_frames,
+            transition_idle * 100 / (transition_frames * SCANLINES)
+        );
+    }
     #endif
+
+    in_transition = active;
+    transition_frames = 0;
+    transition_idle = 0;
 }
 
 IWRAM_SECTION
 void performance_vblank(void) {
+    vblank_total++;
+
+    if(sound_update_cycles > max_sound_cycles)
+        max_sound_cycles = sound_update_cycles;
+    if(music_update_cycles > max_music_cycles)
+        max_music_cycles = music_update_cycles;
+
     static u32 vblanks = 0;
     vblanks++;
 
@@ -63,9 +323,26 @@ void performance_vblank(void) {
 
         tps = ticks;
         fps = frames;
+        late_per_second    = late;
+        dropped_per_second = dropped;
+        if(latency_count > 0)
+            latency = latency_sum * 100 / (latency_count * SCANLINES);
 
         ticks = 0;
         frames = 0;
+        late = 0;
+        dropped = 0;
+        latency_sum = 0;
+        latency_count = 0;
+
+        max_frame_ticks_per_second = max_frame_ticks;
+        max_frame_ticks = 0;
+
+        max_sound_cycles_per_second = max_sound_cycles;
+        max_sound_cycles = 0;
+
+        max_music_cycles_per_second = max_music_cycles;
+        max_music_cycles = 0;
 
         should_refresh = show_performance;
     }
@@ -16,3 +16,6 @@
 #include "scene.h"
 
 const struct Scene *scene = NULL;
+
+EWRAM_BSS_SECTION
+u32 scene_arena[SCENE_ARENA_SIZE / sizeof(u32)];
@@ -18,7 +18,7 @@
 #include "level.h"
 #include "screen.h"
 
-static struct Level level;
+SCENE_ARENA_STATE(struct Level, level);
 
 static inline void setup_tutorial_text(void) {
     // clear first tile of tileset
@@ -31,17 +31,36 @@ static inline void setup_tutorial_text(void) {
     for(u32 y = 0; y < 3; y++)
         for(u32 x = 0; x < 16; x++)
             BG1_TILEMAP[(7 + x) + (15 + y) * 32] = 1 + x + y * 16;
+
+    // the map scene scrolls BG1
+    background_offset(BG1, 0, 0);
+}
+
+static bool game_prepare(u32 selected_level, u32 step) {
+    switch(step) {
+        case 0:
+            level->attempts = 0;
+            level_load(level, &level_metadata[selected_level]);
+            return true;
+
+        case 1:
+            setup_tutorial_text();
+            return true;
+
+        default:
+            // draw the whole level now, so that the draw in 'init' only
+            // has to update it
+            scene_game.draw();
+            return false;
+    }
 }
 
 static void game_init(u32 selected_level) {
-    level.attempts = 0;
-    level_load(&level, &level_metadata[selected_level]);
+    SCENE_ARENA_FOOTPRINT(game, struct Level);
 
     background_toggle(BG2, true); // level's higher tiles
     background_toggle(BG3, true); // level's lower tiles
 
-    setup_tutorial_text();
-
     // draw now to prevent showing garbage on the first frame
     scene_game.draw();
 }
@@ -51,14 +70,16 @@ static void game_tick(void) {
     if(input_press(KEY_START))
         scene_transition_to(&scene_map, BIT(1));
 
-    level_tick(&level);
+    level_tick(level);
 }
 
 static void game_draw(void) {
-    level_draw(&level);
+    level_draw(level);
 }
 
 const struct Scene scene_game = {
+    .prepare = game_prepare,
+
     .init = game_init,
     .tick = game_tick,
     .draw = game_draw
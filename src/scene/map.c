@@ -20,34 +20,255 @@
 #include "crosshair.h"
 #include "storage.h"
 #include "music.h"
+#include "oam.h"
+#include "vram.h"
 
 #include "../res/img/map.c"
 #include "../res/img/map-paths.c"
 #include "../res/img/level-buttons.c"
 
+// a charblock holds 512 tiles of 4bpp
+static_assert(
+    MAP_TILESET_TILES <= 512, "map tileset does not fit in a charblock"
+);
+
+#ifdef SCREEN_FOG_BACKGROUND
+// the fog's tiles follow charblock 1 (see screen.h)
+static_assert(
+    MAP_TILESET_TILES <= 512 + SCREEN_FOG_FIRST_TILE,
+    "map tileset overlaps the fog's tiles"
+);
+#endif
+
+// size of the map image (in tiles)
+#define MAP_W 120
+#define MAP_H 20
+
+// Only the map's columns on the display are loaded in the tilemap: BG1
+// is used as a ring of 32 columns.
+#define LOADED_COLUMNS 31
+
 #define PAGE_COUNT 4
 static u8 first_level_in_pages[PAGE_COUNT] = {
     0, 6, 11, 17
 };
 
 static u16 draw_offset;
-static u32 grass_seed; // random seed used to draw grass
+static i32 first_loaded_column;
 
 static i8 page;
 static i8 level;
 
 static bool block_movement;
 
+// Map sprites are listed page by page: the sprites of a page go from
+// 'first_X_in_pages[page]' to 'first_X_in_pages[page + 1]'.
+static const struct {
+    // coordinates of center
+    i16 x;
+    i16 y;
+} level_buttons[LEVEL_COUNT] = {
+    { 76,  40  },
+    { 76,  80  },
+    { 92,  124 },
+    { 132, 104 },
+    { 144, 56  },
+    { 176, 88  },
+
+    { 316, 38  },
+    { 324, 90  },
+    { 364, 126 },
+    { 392, 86  },
+    { 396, 42  },
+
+    { 548, 37  },
+    { 580, 61  },
+    { 556, 93  },
+    { 588, 129 },
+    { 624, 97  },
+    { 632, 53  }
+};
+
+static const struct {
+    u8 level;
+
+    // coordinates of top-left corner
+    i16 x;
+    i16 y;
+} paths[] = {
+    { 1, 71, 48 },
+
+    { 2, 73, 88 },
+
+    { 3, 100, 107 },
+    { 3, 116, 107 },
+
+    { 4, 133, 62 },
+    { 4, 133, 94 },
+
+    { 5, 149, 55 },
+    { 5, 165, 55 },
+
+    { 6, 183, 66 },
+    { 6, 199, 66 },
+    { 6, 215, 50 },
+    { 6, 231, 50 },
+    { 6, 247, 34 },
+    { 6, 263, 34 },
+    { 6, 279, 34 },
+    { 6, 295, 34 },
+
+    { 7, 315, 46 },
+    { 7, 315, 78 },
+
+    { 8, 329, 94 },
+    { 8, 345, 94 },
+
+    { 9, 366, 92 },
+    { 9, 382, 92 },
+
+    { 10, 389, 49 },
+
+    { 11, 404, 33 },
+    { 11, 420, 33 },
+    { 11, 436, 33 },
+    { 11, 452, 33 },
+    { 11, 468, 33 },
+    { 11, 484, 33 },
+    { 11, 500, 33 },
+    { 11, 516, 33 },
+    { 11, 532, 33 },
+
+    { 12, 550, 41 },
+    { 12, 566, 41 },
+
+    { 13, 557, 69 },
+    { 13, 573, 69 },
+
+    { 14, 558, 99 },
+    { 14, 574, 99 },
+
+    { 15, 595, 100 },
+    { 15, 611, 100 },
+
+    { 16, 623, 60 },
+
+    { 17, 640, 50 },
+    { 17, 656, 50 },
+    { 17, 672, 50 },
+    { 17, 688, 50 },
+    { 17, 704, 50 },
+    { 17, 720, 50 },
+    { 17, 736, 50 },
+    { 17, 752, 50 },
+    { 17, 768, 50 },
+    { 17, 784, 50 },
+    { 17, 800, 50 },
+    { 17, 816, 50 }
+};
+static const u8 first_path_in_pages[PAGE_COUNT + 1] = {
+    0, 12, 28, 46, 53
+};
+#define PATH_COUNT (sizeof(paths) / sizeof(paths[0]))
+
+static const struct {
+    // coordinates of top-left corner
+    i16 x;
+    i16 y;
+} grass[] = {
+    { 84,  24  },
+    { 52,  44  },
+    { 160, 44  },
+    { 116, 60  },
+    { 96,  72  },
+    { 144, 72  },
+    { 96,  96  },
+    { 108, 96  },
+    { 72,  120 },
+
+    { 296, 18  },
+    { 400, 20  },
+    { 380, 22  },
+    { 380, 58  },
+    { 332, 62  },
+    { 308, 98  },
+    { 380, 114 },
+
+    { 576, 13  },
+    { 644, 25  },
+    { 544, 57  },
+    { 640, 61  },
+    { 552, 65  },
+    { 588, 105 },
+    { 600, 129 },
+
+    { 828, 52 },
+    { 828, 68 },
+    { 848, 72 },
+    { 824, 80 }
+};
+static const u8 first_grass_in_pages[PAGE_COUNT + 1] = {
+    0, 9, 16, 23, 27
+};
+#define GRASS_COUNT (sizeof(grass) / sizeof(grass[0]))
+
+// Map sprites only change when the map scrolls or the selected level
+// changes, so they are cached: a still page is drawn by copying the
+// cached sprites, and while scrolling only the pages on the display
+// are visited.
+struct map_Cache {
+    i32 offset;
+    i32 level;
+
+    // set if a visible level button has no image loaded
+    bool missing_buttons;
+
+    u32 ui_count;
+    u32 path_count;
+    u32 grass_count;
+
+    struct Sprite ui[2 * PAGE_COUNT + LEVEL_COUNT];
+    struct Sprite paths[PATH_COUNT];
+    struct Sprite grass[GRASS_COUNT];
+
+    u8 grass_tiles[GRASS_COUNT];
+};
+SCENE_ARENA_STATE(struct map_Cache, cached);
+
+// images currently loaded for each level button
+static const u8 *button_images[LEVEL_COUNT];
+static u16 button_tiles[LEVEL_COUNT];
+
 THUMB
-static void map_init(u32 data) {
+static bool map_prepare(u32 data, u32 step) {
     bool has_cleared_level = (data & BIT(0));
-    bool play_music        = (data & BIT(1));
-    bool select_next_level = (data & BIT(2));
 
-    if(has_cleared_level && level == levels_cleared) {
-        levels_cleared++;
-        storage_save();
+    switch(step) {
+        case 0:
+            if(has_cleared_level && level == levels_cleared) {
+                levels_cleared++;
+                storage_save();
+            }
+            return true;
+
+        default:
+            // load map tileset (the tutorial text may have overwritten it)
+            memory_copy_32(
+                display_charblock(1), map_tileset, MAP_TILESET_TILES * 32
+            );
+
+            // load paths tileset
+            memory_copy_32(display_charblock(5), map_paths, sizeof(map_paths));
+            return false;
     }
+}
+
+THUMB
+static void map_init(u32 data) {
+    SCENE_ARENA_FOOTPRINT(map, struct map_Cache);
+
+    bool play_music        = (data & BIT(1));
+    bool select_next_level = (data & BIT(2));
 
     if(play_music)
         MUSIC_PLAY(music_map);
@@ -72,19 +293,18 @@ static void map_init(u32 data) {
         draw_offset = page * 240;
     }
 
-    // randomly choose a seed for drawing grass
-    grass_seed = random(0x10000) | random(0x10000) << 16;
+    // randomly choose how grass looks
+    for(u32 i = 0; i < GRASS_COUNT; i++)
+        cached->grass_tiles[i] = 48 + random(4);
+
+    // levels_cleared may have changed
+    cached->offset = -1;
 
     // unblock movement between level buttons
     block_movement = false;
 
-    // set tilemap tiles
-    for(u32 y = 0; y < 20; y++)
-        for(u32 x = 0; x < 31; x++)
-            BG1_TILEMAP[x + y * 32] = (x + y * 31) | 1 << 12;
-
-    // load paths tileset
-    memory_copy_32(display_charblock(5), map_paths, sizeof(map_paths));
+    // no column is loaded: load all of them when drawing
+    first_loaded_column = -LOADED_COLUMNS;
 
     // draw now to prevent showing garbage on the first frame
     scene_map.draw();
@@ -112,6 +332,15 @@ static inline void update_draw_offset(void) {
     }
 }
 
+// The images stay resident until other assets need their tiles, so
+// they can still be drawn while the transition fades out.
+static inline void release_button_images(void) {
+    for(u32 i = 0; i < LEVEL_COUNT; i++) {
+        vram_release(button_images[i]);
+        button_images[i] = NULL;
+    }
+}
+
 THUMB
 static void map_tick(void) {
     if(!block_movement) {
@@ -153,46 +382,64 @@ static void map_tick(void) {
     // check if the player has chosen a level
     if(input_press(KEY_A) || input_press(KEY_START)) {
         if(level < LEVEL_COUNT) {
+            release_button_images();
             scene_transition_to(&scene_game, level);
             block_movement = true;
         }
     }
 }
 
-static inline void draw_level_buttons(u32 *used_sprites) {
-    const struct {
-        // coordinates of center
-        i16 x;
-        i16 y;
-    } level_buttons[LEVEL_COUNT] = {
-        { 76,  40  },
-        { 76,  80  },
-        { 92,  124 },
-        { 132, 104 },
-        { 144, 56  },
-        { 176, 88  },
-
-        { 316, 38  },
-        { 324, 90  },
-        { 364, 126 },
-        { 392, 86  },
-        { 396, 42  },
-
-        { 548, 37  },
-        { 580, 61  },
-        { 556, 93  },
-        { 588, 129 },
-        { 624, 97  },
-        { 632, 53  }
-    };
-
-    const u32 buttons = math_min(levels_cleared + 1, LEVEL_COUNT);
-    for(u32 i = 0; i < buttons; i++) {
+static inline bool is_visible(i32 x) {
+    return x >= -16 && x < 240;
+}
+
+static inline void cache_page_arrows(u32 page) {
+    for(u32 i = page * 2; i < page * 2 + 2; i++) {
+        // the first page has no left arrow, the last no right arrow
+        if(i == 0 || i == PAGE_COUNT * 2 - 1)
+            continue;
+
+        // if next page is not unlocked, do not draw right arrow
+        if(i % 2 == 1)
+            if(levels_cleared < first_level_in_pages[i / 2 + 1])
+                continue;
+
+        const i32 y = 24;
+        const i32 x = (i / 2) * 240 + 120
+                      + (i % 2 ? +1 : -1) * 96
+                      - draw_offset;
+
+        if(x < -16 || x >= 240 + 16)
+            continue;
+
+        cached->ui[cached->ui_count++] = (struct Sprite) {
+            .x = x - 16,
+            .y = y - 16,
+
+            .size = SPRITE_SIZE_16x16,
+
+            .tile = 28,
+            .palette = 2,
+
+            .affine = 1,
+            .affine_parameter = i % 2,
+            .double_size = 1
+        };
+    }
+}
+
+static inline void cache_level_buttons(u32 page) {
+    const u32 first = first_level_in_pages[page];
+    const u32 last  = (page + 1 < PAGE_COUNT ?
+                       first_level_in_pages[page + 1] : LEVEL_COUNT);
+
+    const u32 buttons = math_min(levels_cleared + 1, last);
+    for(u32 i = first; i < buttons; i++) {
         // calculate the button's top-left corner
         const i32 x = level_buttons[i].x - draw_offset - 8;
         const i32 y = level_buttons[i].y - 8;
 
-        if(x < -16 || x >= 240)
+        if(!is_visible(x))
             continue;
 
         // load button image
@@ -200,121 +447,47 @@ static inline void draw_level_buttons(u32 *used_sprites) {
         image += 68  * (i == level);          // selected level
         image += 136 * (i == levels_cleared); // uncleared level
 
-        memory_copy_32(
-            (vu8 *) display_charblock(4) + (128 + i * 4) * 32,
-            level_button_images + image * 32,
-            4 * 32
-        );
+        const u8 *image_src = level_button_images + image * 32;
+        if(image_src != button_images[i]) {
+            vram_release(button_images[i]);
+            button_images[i] = NULL;
+
+            // if there is no room, try again in the next frame
+            const u16 tile = vram_acquire(image_src, 4);
+            if(tile == VRAM_NO_TILE) {
+                cached->missing_buttons = true;
+                continue;
+            }
 
-        if(i == level) {
-            // draw crosshair
-            crosshair_draw(*used_sprites, x + 8, y + 8);
-            *used_sprites += 4;
+            button_tiles[i] = tile;
+            button_images[i] = image_src;
         }
 
-        sprite_config((*used_sprites)++, &(struct Sprite) {
+        cached->ui[cached->ui_count++] = (struct Sprite) {
             .x = x,
             .y = y,
 
             .size = SPRITE_SIZE_16x16,
 
-            .tile = 128 + i * 4,
+            .tile = button_tiles[i],
             .palette = 2
-        });
+        };
     }
 }
 
-static inline void draw_paths(u32 *used_sprites) {
-    const struct {
-        u8 level;
-
-        // coordinates of top-left corner
-        i16 x;
-        i16 y;
-    } paths[] = {
-        { 1, 71, 48 },
-
-        { 2, 73, 88 },
-
-        { 3, 100, 107 },
-        { 3, 116, 107 },
-
-        { 4, 133, 62 },
-        { 4, 133, 94 },
-
-        { 5, 149, 55 },
-        { 5, 165, 55 },
-
-        { 6, 183, 66 },
-        { 6, 199, 66 },
-        { 6, 215, 50 },
-        { 6, 231, 50 },
-        { 6, 247, 34 },
-        { 6, 263, 34 },
-        { 6, 279, 34 },
-        { 6, 295, 34 },
-
-        { 7, 315, 46 },
-        { 7, 315, 78 },
-
-        { 8, 329, 94 },
-        { 8, 345, 94 },
-
-        { 9, 366, 92 },
-        { 9, 382, 92 },
-
-        { 10, 389, 49 },
-
-        { 11, 404, 33 },
-        { 11, 420, 33 },
-        { 11, 436, 33 },
-        { 11, 452, 33 },
-        { 11, 468, 33 },
-        { 11, 484, 33 },
-        { 11, 500, 33 },
-        { 11, 516, 33 },
-        { 11, 532, 33 },
-
-        { 12, 550, 41 },
-        { 12, 566, 41 },
-
-        { 13, 557, 69 },
-        { 13, 573, 69 },
-
-        { 14, 558, 99 },
-        { 14, 574, 99 },
-
-        { 15, 595, 100 },
-        { 15, 611, 100 },
-
-        { 16, 623, 60 },
-
-        { 17, 640, 50 },
-        { 17, 656, 50 },
-        { 17, 672, 50 },
-        { 17, 688, 50 },
-        { 17, 704, 50 },
-        { 17, 720, 50 },
-        { 17, 736, 50 },
-        { 17, 752, 50 },
-        { 17, 768, 50 },
-        { 17, 784, 50 },
-        { 17, 800, 50 },
-        { 17, 816, 50 }
-    };
-
-    for(u32 i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+static inline void cache_paths(u32 page) {
+    for(u32 i = first_path_in_pages[page];
+        i < first_path_in_pages[page + 1]; i++) {
         if(paths[i].level > levels_cleared)
             break;
 
         const i32 x = paths[i].x - draw_offset;
         const i32 y = paths[i].y;
 
-        // check if sprite would be inside display area
-        if(x < -16 || x >= 240)
+        if(!is_visible(x))
             continue;
 
-        sprite_config((*used_sprites)++, &(struct Sprite) {
+        cached->paths[cached->path_count++] = (struct Sprite) {
             .x = x,
             .y = y,
 
@@ -322,152 +495,133 @@ static inline void draw_paths(u32 *used_sprites) {
 
             .tile = 512 + i * 8,
             .palette = 0
-        });
+        };
     }
 }
 
-static inline void draw_grass(u32 *used_sprites) {
-    const u32 old_random_seed = random_seed(grass_seed);
-
-    const struct {
-        // coordinates of top-left corner
-        i16 x;
-        i16 y;
-    } grass[] = {
-        { 84,  24  },
-        { 52,  44  },
-        { 160, 44  },
-        { 116, 60  },
-        { 96,  72  },
-        { 144, 72  },
-        { 96,  96  },
-        { 108, 96  },
-        { 72,  120 },
-
-        { 296, 18  },
-        { 400, 20  },
-        { 380, 22  },
-        { 380, 58  },
-        { 332, 62  },
-        { 308, 98  },
-        { 380, 114 },
-
-        { 576, 13  },
-        { 644, 25  },
-        { 544, 57  },
-        { 640, 61  },
-        { 552, 65  },
-        { 588, 105 },
-        { 600, 129 },
-
-        { 828, 52 },
-        { 828, 68 },
-        { 848, 72 },
-        { 824, 80 }
-    };
-
-    for(u32 i = 0; i < sizeof(grass) / sizeof(grass[0]); i++) {
+static inline void cache_grass(u32 page) {
+    for(u32 i = first_grass_in_pages[page];
+        i < first_grass_in_pages[page + 1]; i++) {
         const i32 x = grass[i].x - draw_offset;
         const i32 y = grass[i].y;
 
-        // check if sprite would be inside display area
-        if(x < -16 || x >= 240)
+        if(!is_visible(x))
             continue;
 
-        sprite_config((*used_sprites)++, &(struct Sprite) {
+        cached->grass[cached->grass_count++] = (struct Sprite) {
             .x = x,
             .y = y,
 
             .size = SPRITE_SIZE_8x8,
 
-            .tile = 48 + random(4),
+            .tile = cached->grass_tiles[i],
             .palette = 1
-        });
+        };
     }
+}
+
+static inline void cache_sprites(void) {
+    cached->offset = draw_offset;
+    cached->level  = level;
+
+    cached->missing_buttons = false;
+
+    cached->ui_count    = 0;
+    cached->path_count  = 0;
+    cached->grass_count = 0;
+
+    // pages that may have sprites on the display (page arrows stick
+    // out of their page by up to 32 pixels)
+    const u32 first_page = math_max(draw_offset - 32, 0) / 240;
+    const u32 last_page  = math_min((draw_offset + 239) / 240,
+                                    PAGE_COUNT - 1);
+
+    for(u32 page = first_page; page <= last_page; page++) {
+        cache_page_arrows(page);
+        cache_level_buttons(page);
+        cache_paths(page);
+        cache_grass(page);
+    }
+}
+
+static inline void draw_crosshair(void) {
+    if(level >= LEVEL_COUNT)
+        return;
+
+    const i32 x = level_buttons[level].x - draw_offset;
+    const i32 y = level_buttons[level].y;
 
-    // restore random seed
-    random_seed(old_random_seed);
+    if(is_visible(x - 8))
+        crosshair_draw(x, y);
 }
 
-static inline void draw_page_arrows(u32 *used_sprites) {
+static inline void set_page_arrows_affine(void) {
     // fixed point number: 1 = 0x4000
     // scale = 1.25 + sin(t) / 4   --->   range [1, 1.5]
     i32 scale = 0x5000 + math_sin(tick_count * math_brad(90) / 16) / 4;
 
     // left arrows
-    sprite_affine(0, (i16 [4]) {
+    oam_affine(0, (i16 [4]) {
         256 * 0x4000 / scale, 0,
         0, 256 * 0x4000 / scale
     });
 
     // right arrows
-    sprite_affine(1, (i16 [4]) {
+    oam_affine(1, (i16 [4]) {
         -256 * 0x4000 / scale, 0,
         0, 256 * 0x4000 / scale
     });
+}
 
-    for(u32 i = 1; i < PAGE_COUNT * 2 - 1; i++) {
-        const i32 y = 24;
-        const i32 x = (i / 2) * 240 + 120
-                      + (i % 2 ? +1 : -1) * 96
-                      - draw_offset;
-
-        if(x < -16 || x >= 240 + 16)
-            continue;
-
-        // if next page is not unlocked, do not draw right arrow
-        if(i % 2 == 1)
-            if(levels_cleared < first_level_in_pages[i / 2 + 1])
-                break;
-
-        sprite_config((*used_sprites)++, &(struct Sprite) {
-            .x = x - 16,
-            .y = y - 16,
-
-            .size = SPRITE_SIZE_16x16,
+static inline void load_column(u32 x) {
+    for(u32 y = 0; y < MAP_H; y++)
+        BG1_TILEMAP[(x % 32) + y * 32] = map_tilemap[x + y * MAP_W];
+}
 
-            .tile = 28,
-            .palette = 2,
+// Load the columns that entered the display. While the map is still,
+// nothing is loaded.
+static inline void load_columns(void) {
+    const i32 first = draw_offset / 8;
+    const i32 last  = math_min(first + LOADED_COLUMNS, MAP_W);
 
-            .affine = 1,
-            .affine_parameter = i % 2,
-            .double_size = 1
-        });
+    for(i32 x = first; x < last; x++) {
+        if(x < first_loaded_column ||
+           x >= first_loaded_column + LOADED_COLUMNS)
+            load_column(x);
     }
+    first_loaded_column = first;
 }
 
-THUMB
+IWRAM_SECTION
 static void map_draw(void) {
     background_toggle(BG1, true);  // map
     background_toggle(BG2, false); // level's higher tiles
     background_toggle(BG3, false); // level's lower tiles
 
     // draw sprites
-    u32 used_sprites = SCREEN_FOG_PARTICLE_COUNT;
+    oam_begin(SCREEN_FOG_PARTICLE_COUNT);
 
-    draw_page_arrows(&used_sprites);
-    draw_level_buttons(&used_sprites);
-    draw_paths(&used_sprites);
-    draw_grass(&used_sprites);
+    set_page_arrows_affine();
+    draw_crosshair();
 
-    sprite_hide_range(used_sprites, SPRITE_COUNT);
+    if(cached->offset != draw_offset || cached->level != level ||
+       cached->missing_buttons)
+        cache_sprites();
 
-    // draw tilemap
-    u32 x0 = draw_offset / 8;
-    for(u32 y = 0; y < 20; y++) {
-        // select the y-th tilemap row
-        vu8 *dest = (vu8 *) display_charblock(1) + (y * 31) * 32;
+    oam_request_block(OAM_CLASS_UI, cached->ui, cached->ui_count);
+    oam_request_block(OAM_CLASS_GAMEPLAY, cached->paths, cached->path_count);
+    oam_request_block(OAM_CLASS_DECOR, cached->grass, cached->grass_count);
 
-        // select the left-most tile (rows are 120 tiles long)
-        vu8 *src = (vu8 *) map + (y * 120 + x0) * 32;
+    oam_end();
 
-        dma_config(DMA3, &(struct DMA) { .chunk = DMA_CHUNK_32_BIT });
-        dma_transfer(DMA3, dest, src, 31 * 32 / 4);
-    }
-    background_offset(BG1, draw_offset % 8, 0);
+    // the tilemap is 256 pixels wide: the offset wraps around by itself
+    load_columns();
+    background_offset(BG1, draw_offset, 0);
 }
 
 const struct Scene scene_map = {
+    .prepare = map_prepare,
+
     .init = map_init,
     .tick = map_tick,
     .draw = map_draw
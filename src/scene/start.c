@@ -17,6 +17,7 @@
 
 #include "screen.h"
 #include "music.h"
+#include "vram.h"
 
 #define PAGE_COUNT 9
 
@@ -43,6 +44,50 @@ static struct {
     u16 val;
 } transparency;
 
+// graphics currently loaded for image and text
+static const u8 *loaded_image;
+static const u8 *loaded_text;
+static u16 image_tile;
+static u16 text_tile;
+
+// what the sprites are configured to show (sprites are only configured
+// again when one of these changes)
+static u32 configured_page;
+static u8 configured_element;
+
+#include "../res/img/cutscenes.c"
+#include "../res/img/cutscenes-text.c"
+
+// Acquire the graphics of the current page, if they changed. They are
+// uploaded during VBlank.
+static inline void load_graphics(void) {
+    if(page == PAGE_COUNT) {
+        // the cutscene is over: release its graphics
+        vram_release(loaded_image);
+        vram_release(loaded_text);
+        loaded_image = loaded_text = NULL;
+        return;
+    }
+
+    // If there is no room for the graphics, they are not shown and
+    // acquiring them is tried again in the next tick.
+    const u8 *image_src = cutscenes + (64 * 32) * image_in_page[page];
+    if(image_src != loaded_image) {
+        vram_release(loaded_image);
+        image_tile = vram_acquire(image_src, 64);
+        loaded_image = (image_tile != VRAM_NO_TILE ? image_src : NULL);
+        configured_page = -1;
+    }
+
+    const u8 *text_src = cutscenes_text + (24 * 32) * page;
+    if(text_src != loaded_text) {
+        vram_release(loaded_text);
+        text_tile = vram_acquire(text_src, 24);
+        loaded_text = (text_tile != VRAM_NO_TILE ? text_src : NULL);
+        configured_page = -1;
+    }
+}
+
 THUMB
 static void start_init(u32 data) {
     page = 0;
@@ -52,6 +97,11 @@ static void start_init(u32 data) {
     transparency.dir = +1;
     transparency.val = 0;
 
+    // load the first page and make sure that sprites are configured on
+    // the first draw
+    load_graphics();
+    configured_page = -1;
+
     // play music
     MUSIC_PLAY(music_map);
 }
@@ -113,37 +163,19 @@ static void start_tick(void) {
             transparency.val = 16;
         }
     }
-}
 
-#include "../res/img/cutscenes.c"
-#include "../res/img/cutscenes-text.c"
+    load_graphics();
+}
 
-THUMB
-static void start_draw(void) {
-    // hide all sprites, so that they are not shown when transitioning
-    sprite_hide(-1);
+static inline void configure_sprites(void) {
+    // hide all sprites except fog, so that they are not shown when
+    // transitioning
+    sprite_hide_range(SCREEN_FOG_PARTICLE_COUNT, SPRITE_COUNT);
 
     if(page == PAGE_COUNT)
         return;
 
     const u32 image = image_in_page[page];
-    const u32 text = page;
-
-    // TODO do not repeat this every draw cycle
-    dma_config(DMA3, &(struct DMA) { .chunk = DMA_CHUNK_32_BIT });
-    dma_transfer(
-        DMA3,
-        (vu8 *) display_charblock(4) + 128 * 32,
-        cutscenes + (64 * 32) * image,
-        64 * 32 / 4
-    );
-
-    dma_transfer(
-        DMA3,
-        (vu8 *) display_charblock(4) + 192 * 32,
-        cutscenes_text + (24 * 32) * text,
-        24 * 32 / 4
-    );
 
     const u32 image_x0 = (DISPLAY_WIDTH - 64) / 2;
     const u32 image_y0 = (DISPLAY_HEIGHT - 64) / 2 - 32;
@@ -161,9 +193,11 @@ static void start_draw(void) {
         // set mode to semi-transparent or normal
         .mode = (transparency.element == FADING_IMAGE ? 1 : 0),
 
+        .disable = (loaded_image ? 0 : 1),
+
         .size = SPRITE_SIZE_64x64,
 
-        .tile = 128,
+        .tile = image_tile,
         .palette = (image == 1 ? 0 : 2)
     });
 
@@ -174,17 +208,29 @@ static void start_draw(void) {
             .y = text_y0,
 
             // if the image is being faded, do not show text sprites
-            .disable = (transparency.element == FADING_IMAGE ? 1 : 0),
+            .disable = (transparency.element == FADING_IMAGE ||
+                        !loaded_text ? 1 : 0),
 
             // set mode to semi-transparent or normal
             .mode = (transparency.element == FADING_TEXT ? 1 : 0),
 
             .size = SPRITE_SIZE_32x8,
 
-            .tile = 192 + i * 4,
+            .tile = text_tile + i * 4,
             .palette = 0
         });
     }
+}
+
+THUMB
+static void start_draw(void) {
+    if(page != configured_page ||
+       transparency.element != configured_element) {
+        configure_sprites();
+
+        configured_page = page;
+        configured_element = transparency.element;
+    }
 
     // set color effects (only apply to semi-transparent sprites)
     display_blend(
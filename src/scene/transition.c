@@ -15,11 +15,33 @@
  */
 #include "scene.h"
 
+#include "performance.h"
+
 // it's best if this value is a power of 2, to avoid division
 #define TRANSITION_HALFTIME 32
 
+#ifdef SCENE_FROZEN_TRANSITIONS
+    // The previous scene is frozen from the start, so the next scene
+    // can prepare as soon as the screen is dark, which happens when the
+    // fade reaches 16 (sin(t) >= 16 / 20).
+    #define PREPARE_TIME (TRANSITION_HALFTIME - 19)
+
+    #define HANDOVER_TIME 0
+#else
+    // Number of frames before the midpoint in which the next scene runs
+    // its preparation steps. The screen must already be dark.
+    #define PREPARE_TIME 8
+
+    // When the next scene starts preparing, it takes the scene arena:
+    // from then on, the previous scene is neither ticked nor drawn.
+    #define HANDOVER_TIME (TRANSITION_HALFTIME - PREPARE_TIME)
+#endif
+
 static u32 time;
 
+static u32 prepare_step;
+static bool prepared; // true if there are no more steps to run
+
 static const struct Scene *previous_scene;
 static const struct Scene *next_scene;
 static u32 next_init_data;
@@ -27,16 +49,30 @@ static u32 next_init_data;
 THUMB
 static void transition_init(u32 data) {
     time = 0;
+
+    prepare_step = 0;
+    prepared = (next_scene->prepare == NULL);
+
+    performance_transition(true);
 }
 
 THUMB
 static void transition_tick(void) {
-    if(time < TRANSITION_HALFTIME)
+    if(time < HANDOVER_TIME) {
         previous_scene->tick();
-    else if(time == TRANSITION_HALFTIME)
+    } else if(time < TRANSITION_HALFTIME) {
+        // run one preparation step of the next scene
+        if(time >= TRANSITION_HALFTIME - PREPARE_TIME && !prepared)
+            prepared = !next_scene->prepare(next_init_data, prepare_step++);
+    } else if(time == TRANSITION_HALFTIME) {
+        // if some steps are left, run them now
+        if(!prepared)
+            scene_prepare(next_scene, next_init_data, prepare_step);
+
         next_scene->init(next_init_data);
-    else if(time > TRANSITION_HALFTIME)
+    } else if(time > TRANSITION_HALFTIME) {
         next_scene->tick();
+    }
 
     time++;
 
@@ -44,6 +80,8 @@ static void transition_tick(void) {
     if(time > 2 * TRANSITION_HALFTIME) {
         // set the scene directly: 'scene_set' would call 'init' again
         scene = next_scene;
+
+        performance_transition(false);
     }
 }
 
@@ -56,7 +94,7 @@ static void transition_draw(void) {
 
     display_darken(NULL, fade);
 
-    if(time < TRANSITION_HALFTIME)
+    if(time < HANDOVER_TIME)
         previous_scene->draw();
     else if(time > TRANSITION_HALFTIME)
         next_scene->draw();
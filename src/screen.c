@@ -19,28 +19,111 @@
 #include "res/img/sprites.c"
 #include "res/img/palette.c"
 
-static struct {
-    u8 tile;
+#ifdef SCREEN_FOG_BACKGROUND
 
-    i32 x;
-    i32 y;
+// number of fog tiles scattered in the 32x32 tilemap
+#define FOG_TILES 24
 
-    i16 xm;
-    i16 ym;
-} particles[SCREEN_FOG_PARTICLE_COUNT];
+// fog drift speed (256:1)
+#define FOG_XM (+40)
+#define FOG_YM (-24)
+
+static u32 fog_x;
+static u32 fog_y;
+
+static inline void init_fog_background(void) {
+    background_config(BG0, &(struct Background) {
+        .priority = 0,
+        .tileset  = 2,
+        .tilemap  = 0
+    });
+
+    // the first tile is transparent, followed by the fog tiles
+    vu8 *fog_tileset = (vu8 *) display_charblock(2) +
+                       SCREEN_FOG_FIRST_TILE * 32;
+    memory_clear_32(fog_tileset, 32);
+    memory_copy_32(fog_tileset + 32, sprites + 56 * 32, 8 * 32);
+
+    // fill the tilemap with transparent tiles
+    for(u32 i = 0; i < 32 * 32; i++)
+        BG0_TILEMAP[i] = SCREEN_FOG_FIRST_TILE;
+
+    // scatter fog tiles of random size
+    for(u32 i = 0; i < FOG_TILES; i++) {
+        BG0_TILEMAP[random(32 * 32)] =
+            (SCREEN_FOG_FIRST_TILE + 1 + random(8)) | 1 << 12;
+    }
+
+    fog_x = 0;
+    fog_y = 0;
+
+    background_toggle(BG0, true);
+}
+
+#else
+
+// size of the noise tables (must be a power of 2)
+#define NOISE_SIZE 256
+
+// particle state, stored as separate arrays
+static u32 particle_x[SCREEN_FOG_PARTICLE_COUNT]; // (256:1)
+static u32 particle_y[SCREEN_FOG_PARTICLE_COUNT]; // (256:1)
+static i32 particle_xm[SCREEN_FOG_PARTICLE_COUNT];
+static i32 particle_ym[SCREEN_FOG_PARTICLE_COUNT];
+static i32 particle_tile[SCREEN_FOG_PARTICLE_COUNT];
+
+// Precomputed random changes of velocity and tile. Each particle reads
+// these tables at a different offset, advancing by one every tick.
+static i8 noise_xm[NOISE_SIZE];
+static i8 noise_ym[NOISE_SIZE];
+static i8 noise_tile[NOISE_SIZE];
+
+static INLINE void swap_noise(i8 *noise, u32 a, u32 b) {
+    const i8 tmp = noise[a];
+    noise[a] = noise[b];
+    noise[b] = tmp;
+}
+
+static inline void shuffle_noise(i8 *noise) {
+    for(u32 i = NOISE_SIZE - 1; i > 0; i--) {
+        swap_noise(noise, i, random(i + 1));
+    }
+}
 
 static inline void init_fog_particles(void) {
     for(u32 i = 0; i < SCREEN_FOG_PARTICLE_COUNT; i++) {
-        particles[i].tile = 0;
+        particle_tile[i] = 0;
+
+        particle_x[i] = 256 * random(DISPLAY_WIDTH);
+        particle_y[i] = 256 * random(DISPLAY_HEIGHT);
+
+        particle_xm[i] = random(17) - 8;
+        particle_ym[i] = random(17) - 8;
+    }
+
+    // Velocity changes come in opposite pairs, so that each table sums
+    // to zero and particles do not all drift the same way.
+    for(u32 i = 0; i < NOISE_SIZE; i += 2) {
+        noise_xm[i] = random(9) - 4;
+        noise_ym[i] = random(9) - 4;
 
-        particles[i].x = 256 * random(DISPLAY_WIDTH);
-        particles[i].y = 256 * random(DISPLAY_HEIGHT);
+        noise_xm[i + 1] = -noise_xm[i];
+        noise_ym[i + 1] = -noise_ym[i];
+    }
+    shuffle_noise(noise_xm);
+    shuffle_noise(noise_ym);
 
-        particles[i].xm = random(17) - 8;
-        particles[i].ym = random(17) - 8;
+    for(u32 i = 0; i < NOISE_SIZE; i++) {
+        // 1/4 chance of changing tile: half of the times it shrinks
+        if(random(4) == 0)
+            noise_tile[i] = random(2) == 0 ? -1 : +1;
+        else
+            noise_tile[i] = 0;
     }
 }
 
+#endif
+
 #define LOAD_TILESET(dest, tileset)\
     memory_copy_32((dest), (tileset), sizeof(tileset))
 
@@ -64,14 +147,18 @@ void screen_init(void) {
     background_config(BG2, &(struct Background) {
         .priority = 2,
         .tileset  = 3,
-        .tilemap  = 4
+        .tilemap  = 4,
+
+        .size = 1 // 512x256: two screenblocks, see 'TILE_RING_W'
     });
 
     // level's lower tiles
     background_config(BG3, &(struct Background) {
         .priority = 3,
         .tileset  = 3,
-        .tilemap  = 6
+        .tilemap  = 6,
+
+        .size = 1 // 512x256: two screenblocks, see 'TILE_RING_W'
     });
 
     // load tileset and spritesheet
@@ -82,45 +169,88 @@ void screen_init(void) {
     LOAD_PALETTE(DISPLAY_BG_PALETTE,  palette);
     LOAD_PALETTE(DISPLAY_OBJ_PALETTE, palette);
 
+    #ifdef SCREEN_FOG_BACKGROUND
+    init_fog_background();
+    #else
     init_fog_particles();
+    #endif
 
     // disable forced blank
     display_force_blank(false);
 }
 
+#ifdef SCREEN_FOG_BACKGROUND
+
 IWRAM_SECTION
-void screen_draw_fog_particles(u32 first_sprite_id) {
+void screen_draw_fog(u32 first_sprite_id) {
+    // no sprites are used
+    (void) first_sprite_id;
+
+    fog_x += FOG_XM;
+    fog_y += FOG_YM;
+
+    // the tilemap is 256x256 pixels: offsets wrap around by themselves
+    background_offset(BG0, fog_x / 256, fog_y / 256);
+
+    // Blend fog with the layers below. Scenes using color effects
+    // (e.g. transitions) override this, since they are drawn later.
+    display_blend(
+        &(struct DisplayTarget) { .bg0 = 1 },
+        &(struct DisplayTarget) {
+            .bg1 = 1, .bg2 = 1, .bg3 = 1, .obj = 1, .backdrop = 1
+        },
+        8, 12
+    );
+}
+
+#else
+
+IWRAM_SECTION
+void screen_draw_fog(u32 first_sprite_id) {
+    // Keep shuffling the velocity tables, one swap per frame, so that
+    // the particles' motion does not repeat every NOISE_SIZE ticks.
+    // Swapping keeps each table's sum at zero.
+    swap_noise(noise_xm, random(NOISE_SIZE), random(NOISE_SIZE));
+    swap_noise(noise_ym, random(NOISE_SIZE), random(NOISE_SIZE));
+
+    u32 noise = tick_count;
+
     for(u32 i = 0; i < SCREEN_FOG_PARTICLE_COUNT; i++) {
+        const u32 n = noise % NOISE_SIZE;
+        noise += 37;
+
         // update particle tile
-        if(random(4) == 0) {
-            if(random(2) == 0 && particles[i].tile > 0)
-                particles[i].tile--;
-            else if(particles[i].tile < 7)
-                particles[i].tile++;
-        }
-
-        // randomly change velocity
-        particles[i].xm += random(9) - 4;
-        particles[i].ym += random(9) - 4;
-
-        if(math_abs(particles[i].xm) > 128)
-            particles[i].xm /= 2;
-        if(math_abs(particles[i].ym) > 128)
-            particles[i].ym /= 2;
+        i32 tile = particle_tile[i] + noise_tile[n];
+        if(tile < 0) tile = 0;
+        if(tile > 7) tile = 7;
+        particle_tile[i] = tile;
+
+        // change velocity
+        i32 xm = particle_xm[i] + noise_xm[n];
+        i32 ym = particle_ym[i] + noise_ym[n];
+
+        if(xm > 128 || xm < -128)
+            xm /= 2;
+        if(ym > 128 || ym < -128)
+            ym /= 2;
+
+        particle_xm[i] = xm;
+        particle_ym[i] = ym;
 
         // add velocity to particle position
-        particles[i].x += particles[i].xm;
-        particles[i].y += particles[i].ym;
+        const u32 x = (particle_x[i] += xm);
+        const u32 y = (particle_y[i] += ym);
 
-        // draw sprite
         sprite_config(first_sprite_id + i, &(struct Sprite) {
-            .x = (particles[i].x / 256) % 256 - 4,
-            .y = (particles[i].y / 256) % 256 - 4,
+            .x = (x / 256) % 256 - 4,
+            .y = (y / 256) % 256 - 4,
 
             .size = SPRITE_SIZE_8x8,
 
-            .tile = 56 + particles[i].tile,
+            .tile = 56 + tile,
             .palette = 1
         });
     }
 }
+
+#endif
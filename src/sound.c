@@ -0,0 +1,48 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "sound.h"
+
+#include "music.h"
+
+u32 sound_update_cycles;
+
+IWRAM_SECTION
+static void sound_isr(void) {
+    const u16 start = timer_get_counter(SOUND_TIMER);
+    audio_update();
+    const u16 end = timer_get_counter(SOUND_TIMER);
+
+    sound_update_cycles = (u16) (end - start) * 64;
+
+    music_update();
+}
+
+void sound_init(void) {
+    timer_config(SOUND_TIMER, &(struct Timer) {
+        .prescaler = TIMER_PRESCALER_64,
+        .irq = true
+    });
+    interrupt_isr(SOUND_TIMER_IRQ, sound_isr);
+    interrupt_toggle(SOUND_TIMER_IRQ, true);
+
+    // The counter register sets the value loaded when the timer starts
+    // or overflows: set it to one frame, then start the timer as VBlank
+    // ends, so that every update happens at the end of VBlank.
+    timer_set_counter(SOUND_TIMER, 0x10000 - SOUND_FRAME_TICKS);
+    interrupt_wait(IRQ_VBLANK);
+    while(display_vcount() >= DISPLAY_HEIGHT);
+    timer_start(SOUND_TIMER);
+}
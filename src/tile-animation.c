@@ -0,0 +1,132 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "tile.h"
+
+#include "upload.h"
+#include "job.h"
+
+// Animated tiles are animated by changing their graphics in VRAM (or
+// their colors in the palette), so that every tilemap entry using them
+// is animated without redrawing the tilemap.
+
+#define WATER_FRAMES     4
+#define WATER_FRAME_TIME 8
+
+#define HOLE_COLOR_TIME 16
+
+static const u16 water_tiles[] = {
+    28, 29, 34, 35, // water
+    40, 41, 46, 47, // water with platform
+    52, 53, 58, 59  // water with platform, below editor cursor
+};
+#define WATER_TILES (sizeof(water_tiles) / sizeof(water_tiles[0]))
+
+// each tile row (8 pixels, 4bpp) fits in a single word
+static u32 water_frames[WATER_FRAMES][WATER_TILES][8];
+
+// water frames are generated by a background job, one tile at a time
+static u32 generated_tiles;
+
+static u32 water_frame;
+static u32 next_upload; // next tile to post (WATER_TILES = done)
+
+// Hole tiles only use color 3: it pulses between its own value and
+// the darker color 2 of the palette.
+#define HOLE_COLOR_INDEX 3
+static const u16 hole_colors[] = {
+    0x314c, 0x2909, 0x20c7, 0x2909
+};
+#define HOLE_COLORS (sizeof(hole_colors) / sizeof(hole_colors[0]))
+
+// Make lines of lighter color (9) run down the darker water (8). The
+// row is counted from the top of the 16x16 tile, so that the lines
+// move continuously across the two 8x8 tiles.
+static inline u32 water_row(u32 row_data, u32 row, u32 frame) {
+    if((row + WATER_FRAMES - frame) % WATER_FRAMES != 0)
+        return row_data;
+
+    for(u32 p = 0; p < 8; p++) {
+        const u32 shift = p * 4;
+        if(((row_data >> shift) & 0xf) == 8)
+            row_data ^= (8 ^ 9) << shift;
+    }
+    return row_data;
+}
+
+// Generate the next tile of the water frames from the tileset already
+// in VRAM (water is not animated until all of them are generated).
+static bool generate_water_tile(u32 data) {
+    const vu32 *tileset = (vu32 *) display_charblock(3);
+
+    const u32 f = generated_tiles / WATER_TILES;
+    const u32 t = generated_tiles % WATER_TILES;
+
+    // tiles are listed as top-left, top-right, bottom-left...
+    const u32 row0 = (t % 4 >= 2) ? 8 : 0;
+
+    for(u32 r = 0; r < 8; r++) {
+        water_frames[f][t][r] = water_row(
+            tileset[water_tiles[t] * 8 + r], row0 + r, f
+        );
+    }
+
+    generated_tiles++;
+    return generated_tiles < WATER_FRAMES * WATER_TILES;
+}
+
+void tile_animation_init(void) {
+    // holes use a copy of the first palette, so that their color can
+    // be cycled without affecting other tiles
+    memory_copy_32(
+        DISPLAY_BG_PALETTE + TILE_HOLE_PALETTE * 16,
+        DISPLAY_BG_PALETTE, 16 * sizeof(u16)
+    );
+
+    generated_tiles = 0;
+    job_add(generate_water_tile, 0);
+
+    water_frame = 0;
+    next_upload = WATER_TILES;
+}
+
+IWRAM_SECTION
+void tile_animation_update(void) {
+    // if the frame changed, start uploading its tiles
+    const u32 frame = (tick_count / WATER_FRAME_TIME) % WATER_FRAMES;
+    if(frame != water_frame &&
+       generated_tiles == WATER_FRAMES * WATER_TILES) {
+        water_frame = frame;
+        next_upload = 0;
+    }
+
+    // post the frame's tiles to the upload queue: if it is full, the
+    // rest is posted in the next frames
+    while(next_upload < WATER_TILES) {
+        const bool queued = upload_post(
+            (vu8 *) display_charblock(3) + water_tiles[next_upload] * 32,
+            water_frames[water_frame][next_upload],
+            32, DMA_CHUNK_32_BIT
+        );
+        if(!queued)
+            break;
+        next_upload++;
+    }
+
+    // cycle the color of holes
+    DISPLAY_BG_PALETTE[TILE_HOLE_PALETTE * 16 + HOLE_COLOR_INDEX] = hole_colors[
+        (tick_count / HOLE_COLOR_TIME) % HOLE_COLORS
+    ];
+}
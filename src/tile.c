@@ -23,59 +23,178 @@
     IWRAM_SECTION\
     static void name(struct Level *level, i32 xt, i32 yt)
 
+// The level's tilemaps are two screenblocks wide (64x32 entries) and
+// coordinates wrap around, so that they work as a ring of tiles.
+static INLINE vu16 *tilemap_entry(vu16 *tilemap, i32 x, i32 y) {
+    x &= 63;
+    y &= 31;
+    return &tilemap[(x >> 5) * 32 * 32 + (x & 31) + y * 32];
+}
+
 #define GET_LOW(level, xt, yt)\
-    (&BG3_TILEMAP[(xt) * 2 + ((yt) * 2) * 32])
+    tilemap_entry(BG3_TILEMAP, (xt) * 2, (yt) * 2)
 
 #define GET_HIGH(level, xt, yt)\
-    (&BG2_TILEMAP[(xt) * 2 + ((yt) * 2) * 32])
+    tilemap_entry(BG2_TILEMAP, (xt) * 2, (yt) * 2)
+
+#define TILE(number, flip, palette) (\
+    ((number)  & 0x3ff) << 0  |       \
+    ((flip)    & 0x03)  << 10 |       \
+    ((palette) & 0x0f)  << 12         \
+)
+
+// A metatile holds the four tilemap entries of a 16x16 tile, packed
+// so that each row can be written with a single 32-bit store.
+struct Metatile {
+    u32 top;
+    u32 bottom;
+};
 
-#define TILE get_tile_value
+#define ROW(left, right) ((u32) (left) | (u32) (right) << 16)
 
-static INLINE u16 get_tile_value(u32 number, u32 flip, u32 palette) {
-    return (number  & 0x3ff) << 0  |
-           (flip    & 0x03)  << 10 |
-           (palette & 0x0f)  << 12;
+#define METATILE(top_left, top_right, bottom_left, bottom_right) {\
+    .top    = ROW(top_left, top_right),                          \
+    .bottom = ROW(bottom_left, bottom_right)                     \
 }
 
-IWRAM_SECTION
-static void draw_outer_borders(struct Level *level, i32 xt, i32 yt) {
-    vu16 *low = GET_LOW(level, xt, yt);
+// a tile repeated four times, each time flipped differently
+#define FLIPPED_METATILE(tile, palette) METATILE(  \
+    TILE(tile, 0, palette), TILE(tile, 1, palette), \
+    TILE(tile, 2, palette), TILE(tile, 3, palette)  \
+)
+
+static INLINE void write_metatile(vu16 *tilemap,
+                                  const struct Metatile *metatile) {
+    *(vu32 *) &tilemap[0]  = metatile->top;
+    *(vu32 *) &tilemap[32] = metatile->bottom;
+}
+
+static const struct Metatile empty_metatile = METATILE(0, 0, 0, 0);
 
-    bool left  = level_get_tile(level, xt - 1, yt) == TILE_VOID;
-    bool right = level_get_tile(level, xt + 1, yt) == TILE_VOID;
-    bool up    = level_get_tile(level, xt, yt - 1) == TILE_VOID;
-    bool down  = level_get_tile(level, xt, yt + 1) == TILE_VOID;
+static const struct Metatile ground_metatile = METATILE(
+    TILE(6, 0, 0), TILE(6, 0, 0),
+    TILE(6, 0, 0), TILE(6, 0, 0)
+);
 
-    bool top_left  = level_get_tile(level, xt - 1, yt - 1) == TILE_VOID;
-    bool top_right = level_get_tile(level, xt + 1, yt - 1) == TILE_VOID;
+static const struct Metatile hole_metatile =
+    FLIPPED_METATILE(5, TILE_HOLE_PALETTE);
 
-    if(down) {
-        low[64] = TILE(12, 0, 0);
-        low[65] = TILE(12, 0, 0);
+// [0] = normal, [1] = below editor cursor, [2] = below cursor, occupied
+static const struct Metatile platform_metatiles[3] = {
+    FLIPPED_METATILE(3, 0),
+    FLIPPED_METATILE(9, 1),
+    FLIPPED_METATILE(10, 0)
+};
+
+// [0] = normal, [1] = below editor cursor
+static const struct Metatile fall_platform_metatiles[2] = {
+    FLIPPED_METATILE(4, 1),
+    FLIPPED_METATILE(10, 0)
+};
+
+// High ground metatiles, indexed by which neighbors are not high
+// ground: bit 0 = left, bit 1 = right, bit 2 = up, bit 3 = down.
+#define HIGH_GROUND(left, right, up, down) METATILE(\
+    TILE((left  && up)   ? 2  : 8, 1, 0),           \
+    TILE((right && up)   ? 2  : 8, 0, 0),           \
+    TILE((left  && down) ? 14 : 8, 1, 0),           \
+    TILE((right && down) ? 14 : 8, 0, 0)            \
+)
+#define HIGH_GROUND_I(i)\
+    HIGH_GROUND((i) & 1, (i) & 2, (i) & 4, (i) & 8)
+
+static const struct Metatile high_ground_metatiles[16] = {
+    HIGH_GROUND_I(0),  HIGH_GROUND_I(1),  HIGH_GROUND_I(2),
+    HIGH_GROUND_I(3),  HIGH_GROUND_I(4),  HIGH_GROUND_I(5),
+    HIGH_GROUND_I(6),  HIGH_GROUND_I(7),  HIGH_GROUND_I(8),
+    HIGH_GROUND_I(9),  HIGH_GROUND_I(10), HIGH_GROUND_I(11),
+    HIGH_GROUND_I(12), HIGH_GROUND_I(13), HIGH_GROUND_I(14),
+    HIGH_GROUND_I(15)
+};
+
+// lower border of high ground, indexed by left and right (bits 0-1)
+static const u32 high_ground_borders[4] = {
+    ROW(TILE(12, 1, 0), TILE(12, 0, 0)),
+    ROW(TILE(20, 1, 0), TILE(12, 0, 0)),
+    ROW(TILE(12, 1, 0), TILE(20, 0, 0)),
+    ROW(TILE(20, 1, 0), TILE(20, 0, 0))
+};
 
-        if(left)
-            low[63] = TILE(13, 1, 0);
-        if(right)
-            low[66] = TILE(13, 0, 0);
+// Obstacle metatiles, indexed by obstacle type, platform variant (none,
+// platform, platform below editor cursor) and flip.
+#define OBSTACLE(base, flip, palette) METATILE(\
+    TILE((base)     + (flip), flip, palette),  \
+    TILE((base) + 1 - (flip), flip, palette),  \
+    TILE((base) + 6 + (flip), flip, palette),  \
+    TILE((base) + 7 - (flip), flip, palette)   \
+)
+#define OBSTACLE_VARIANTS(base, palette) {                          \
+    { OBSTACLE((base),      0, palette), OBSTACLE((base),      1, palette) },\
+    { OBSTACLE((base) + 12, 0, palette), OBSTACLE((base) + 12, 1, palette) },\
+    { OBSTACLE((base) + 24, 0, palette), OBSTACLE((base) + 24, 1, palette) } \
+}
+
+static const struct Metatile
+obstacle_metatiles[LEVEL_OBSTACLE_TYPES][3][2] = {
+    OBSTACLE_VARIANTS(24, 1), // wood
+    OBSTACLE_VARIANTS(26, 0), // rock
+    OBSTACLE_VARIANTS(28, 0)  // water
+};
+
+static INLINE bool is_void(struct Level *level, i32 xt, i32 yt) {
+    return level_get_tile(level, xt, yt) == TILE_VOID;
+}
+
+// every tile, except void and invalid tiles, has borders
+static INLINE bool has_borders(struct Level *level, i32 xt, i32 yt) {
+    const enum tile_TypeID tile = level_get_tile(level, xt, yt);
+    return tile != TILE_VOID && tile != TILE_INVALID;
+}
+
+// Void tiles show the borders of the tiles around them. Where borders
+// overlap, those of the tiles on the sides are drawn over those of the
+// tiles above.
+DRAW_FUNC(void_draw) {
+    vu16 *low = GET_LOW(level, xt, yt);
+
+    u16 top_left = 0, top_right = 0, bottom_left = 0, bottom_right = 0;
+
+    // corners of the diagonal tiles above
+    if(is_void(level, xt, yt - 1)) {
+        if(has_borders(level, xt - 1, yt - 1) && is_void(level, xt - 1, yt))
+            top_left = TILE(13, 0, 0);
+        if(has_borders(level, xt + 1, yt - 1) && is_void(level, xt + 1, yt))
+            top_right = TILE(13, 1, 0);
     }
 
-    if(left) {
-        low[31] = TILE(down ? 7 : 19, 1, 0);
+    // lower border of the tile above
+    if(has_borders(level, xt, yt - 1)) {
+        top_left  = TILE(12, 0, 0);
+        top_right = TILE(12, 0, 0);
+    }
 
-        if(up)
-            low[-1] = TILE(1, 1, 0);
+    // right border of the tile on the left
+    if(has_borders(level, xt - 1, yt)) {
+        if(is_void(level, xt - 1, yt - 1))
+            top_left = TILE(1, 0, 0);
         else
-            low[-1] = TILE(top_left ? 19 : 18, 1, 0);
-    }
+            top_left = TILE(is_void(level, xt, yt - 1) ? 19 : 18, 0, 0);
 
-    if(right) {
-        low[34] = TILE(down ? 7 : 19, 0, 0);
+        bottom_left = TILE(is_void(level, xt - 1, yt + 1) ? 7 : 19, 0, 0);
+    }
 
-        if(up)
-            low[2] = TILE(1, 0, 0);
+    // left border of the tile on the right
+    if(has_borders(level, xt + 1, yt)) {
+        if(is_void(level, xt + 1, yt - 1))
+            top_right = TILE(1, 1, 0);
         else
-            low[2] = TILE(top_right ? 19 : 18, 0, 0);
+            top_right = TILE(is_void(level, xt, yt - 1) ? 19 : 18, 1, 0);
+
+        bottom_right = TILE(is_void(level, xt + 1, yt + 1) ? 7 : 19, 1, 0);
     }
+
+    *(vu32 *) &low[0]  = ROW(top_left, top_right);
+    *(vu32 *) &low[32] = ROW(bottom_left, bottom_right);
 }
 
 static INLINE bool editor_on_top(struct Level *level, i32 xt, i32 yt) {
@@ -87,44 +206,16 @@ static INLINE bool editor_on_top(struct Level *level, i32 xt, i32 yt) {
 DRAW_FUNC(ground_draw) {
     vu16 *low = GET_LOW(level, xt, yt);
 
-    low[0]  = TILE(6, 0, 0);
-    low[1]  = TILE(6, 0, 0);
-    low[32] = TILE(6, 0, 0);
-    low[33] = TILE(6, 0, 0);
-
-    draw_outer_borders(level, xt, yt);
-}
-
-DRAW_FUNC(high_ground_draw) {
-    ground_draw(level, xt, yt);
-
-    vu16 *high = GET_HIGH(level, xt, yt);
-
-    bool left  = level_get_tile(level, xt - 1, yt) != TILE_HIGH_GROUND;
-    bool right = level_get_tile(level, xt + 1, yt) != TILE_HIGH_GROUND;
-    bool up    = level_get_tile(level, xt, yt - 1) != TILE_HIGH_GROUND;
-    bool down  = level_get_tile(level, xt, yt + 1) != TILE_HIGH_GROUND;
-
-    high[0]  = TILE((left  && up) ? 2 : 8, 1, 0);
-    high[1]  = TILE((right && up) ? 2 : 8, 0, 0);
-    high[32] = TILE((left  && down) ? 14 : 8, 1, 0);
-    high[33] = TILE((right && down) ? 14 : 8, 0, 0);
-
-    if(down) {
-        high[64] = TILE(left  ? 20 : 12, 1, 0);
-        high[65] = TILE(right ? 20 : 12, 0, 0);
-    }
+    write_metatile(low, &ground_metatile);
 }
 
 DRAW_FUNC(platform_draw) {
     vu16 *low = GET_LOW(level, xt, yt);
 
-    u32 tile    = 3;
-    u32 palette = 0;
+    u32 variant = 0;
     if(editor_on_top(level, xt, yt)) {
         // green color
-        tile    = 9;
-        palette = 1;
+        variant = 1;
 
         // check if there is a solid entity (player or mailbox) on tile
         for(u32 i = 0; i < LEVEL_SOLID_ENTITIES_IN_TILE; i++) {
@@ -133,85 +224,59 @@ DRAW_FUNC(platform_draw) {
 
             if(id < LEVEL_ENTITY_LIMIT) {
                 // red color
-                tile    = 10;
-                palette = 0;
+                variant = 2;
                 break;
             }
         }
     }
 
-    low[0]  = TILE(tile, 0, palette);
-    low[1]  = TILE(tile, 1, palette);
-    low[32] = TILE(tile, 2, palette);
-    low[33] = TILE(tile, 3, palette);
-
-    draw_outer_borders(level, xt, yt);
+    write_metatile(low, &platform_metatiles[variant]);
 }
 
 DRAW_FUNC(fall_platform_draw) {
     vu16 *low = GET_LOW(level, xt, yt);
 
-    u32 tile    = 4;
-    u32 palette = 1;
-    if(editor_on_top(level, xt, yt)) {
-        tile    = 10;
-        palette = 0;
-    }
-
-    low[0]  = TILE(tile, 0, palette);
-    low[1]  = TILE(tile, 1, palette);
-    low[32] = TILE(tile, 2, palette);
-    low[33] = TILE(tile, 3, palette);
-
-    draw_outer_borders(level, xt, yt);
+    const u32 variant = editor_on_top(level, xt, yt);
+    write_metatile(low, &fall_platform_metatiles[variant]);
 }
 
 DRAW_FUNC(hole_draw) {
     vu16 *low = GET_LOW(level, xt, yt);
 
-    low[0]  = TILE(5, 0, 0);
-    low[1]  = TILE(5, 1, 0);
-    low[32] = TILE(5, 2, 0);
-    low[33] = TILE(5, 3, 0);
-
-    draw_outer_borders(level, xt, yt);
+    write_metatile(low, &hole_metatile);
 }
 
 static INLINE void draw_obstacle(struct Level *level, i32 xt, i32 yt,
-                                 u32 base, u32 palette) {
+                                 u32 obstacle) {
     vu16 *low = GET_LOW(level, xt, yt);
 
     u8 data = level_get_data(level, xt, yt);
     bool platform = data & BIT(0);
     bool flip     = data & BIT(1);
 
+    u32 variant = 0;
     if(platform)
-        base += 12 + 12 * editor_on_top(level, xt, yt);
-
-    low[0]  = TILE(base     + flip, flip, palette);
-    low[1]  = TILE(base + 1 - flip, flip, palette);
-    low[32] = TILE(base + 6 + flip, flip, palette);
-    low[33] = TILE(base + 7 - flip, flip, palette);
+        variant = 1 + editor_on_top(level, xt, yt);
 
-    draw_outer_borders(level, xt, yt);
+    write_metatile(low, &obstacle_metatiles[obstacle][variant][flip]);
 }
 
 DRAW_FUNC(wood_draw) {
-    draw_obstacle(level, xt, yt, 24, 1);
+    draw_obstacle(level, xt, yt, 0);
 }
 
 DRAW_FUNC(rock_draw) {
-    draw_obstacle(level, xt, yt, 26, 0);
+    draw_obstacle(level, xt, yt, 1);
 }
 
 DRAW_FUNC(water_draw) {
-    draw_obstacle(level, xt, yt, 28, 0);
+    draw_obstacle(level, xt, yt, 2);
 }
 
 const struct tile_Type tile_type_list[TILE_TYPES] = {
     [TILE_VOID] = {
         .is_solid = false,
-        .draw = NULL
+        .draw = void_draw
     },
 
     [TILE_GROUND] = {
@@ -220,7 +285,7 @@ const struct tile_Type tile_type_list[TILE_TYPES] = {
     },
     [TILE_HIGH_GROUND] = {
         .is_solid = true,
-        .draw = high_ground_draw
+        .draw = ground_draw // higher tiles are drawn by 'tile_draw'
     },
 
     [TILE_PLATFORM] = {
@@ -249,3 +314,42 @@ const struct tile_Type tile_type_list[TILE_TYPES] = {
         .draw = water_draw
     }
 };
+
+// Higher tiles: high ground and the lower border it casts on the tile
+// below. Every other entry of the higher tilemap is left empty.
+static INLINE void draw_high(struct Level *level, i32 xt, i32 yt) {
+    vu16 *high = GET_HIGH(level, xt, yt);
+
+    if(level_get_tile(level, xt, yt) == TILE_HIGH_GROUND) {
+        bool left  = level_get_tile(level, xt - 1, yt) != TILE_HIGH_GROUND;
+        bool right = level_get_tile(level, xt + 1, yt) != TILE_HIGH_GROUND;
+        bool up    = level_get_tile(level, xt, yt - 1) != TILE_HIGH_GROUND;
+        bool down  = level_get_tile(level, xt, yt + 1) != TILE_HIGH_GROUND;
+
+        write_metatile(high, &high_ground_metatiles[
+            left << 0 | right << 1 | up << 2 | down << 3
+        ]);
+    } else if(level_get_tile(level, xt, yt - 1) == TILE_HIGH_GROUND) {
+        bool left  = level_get_tile(level, xt - 1, yt - 1) != TILE_HIGH_GROUND;
+        bool right = level_get_tile(level, xt + 1, yt - 1) != TILE_HIGH_GROUND;
+
+        *(vu32 *) &high[0]  = high_ground_borders[left << 0 | right << 1];
+        *(vu32 *) &high[32] = 0;
+    } else {
+        write_metatile(high, &empty_metatile);
+    }
+}
+
+IWRAM_SECTION
+void tile_draw(struct Level *level, i32 xt, i32 yt) {
+    const struct tile_Type *type = tile_get_type(
+        level_get_tile(level, xt, yt)
+    );
+
+    if(type)
+        type->draw(level, xt, yt);
+    else
+        write_metatile(GET_LOW(level, xt, yt), &empty_metatile);
+
+    draw_high(level, xt, yt);
+}
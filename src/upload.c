@@ -0,0 +1,91 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "upload.h"
+
+u32 upload_queue_depth;
+u32 upload_flushed_bytes;
+
+static struct {
+    vu8 *dst;
+    const vu8 *src;
+    u32 bytes;
+    u32 chunk;
+} queue[UPLOAD_QUEUE_SIZE];
+
+static u32 first;
+static u32 count;
+
+static INLINE u32 chunk_bytes(u32 chunk) {
+    return (chunk == DMA_CHUNK_32_BIT ? 4 : 2);
+}
+
+bool upload_post(volatile void *dst, const volatile void *src,
+                 u32 bytes, u32 chunk) {
+    if(count == UPLOAD_QUEUE_SIZE)
+        return false;
+
+    // the flush copies whole chunks only
+    if(bytes % chunk_bytes(chunk) != 0)
+        return false;
+
+    // nothing to copy
+    if(bytes == 0)
+        return true;
+
+    const u32 i = (first + count) % UPLOAD_QUEUE_SIZE;
+    queue[i].dst   = dst;
+    queue[i].src   = src;
+    queue[i].bytes = bytes;
+    queue[i].chunk = chunk;
+
+    count++;
+    upload_queue_depth = count;
+    return true;
+}
+
+IWRAM_SECTION
+void upload_flush(void) {
+    u32 budget = UPLOAD_BUDGET;
+    upload_flushed_bytes = 0;
+
+    while(count > 0) {
+        // copy whole chunks: stop if not even one fits in the budget
+        const u32 unit = chunk_bytes(queue[first].chunk);
+        const u32 bytes = math_min(queue[first].bytes, budget) / unit * unit;
+        if(bytes == 0)
+            break;
+
+        dma_config(DMA3, &(struct DMA) {
+            .chunk = queue[first].chunk
+        });
+        dma_transfer(DMA3, queue[first].dst, queue[first].src,
+                     bytes / unit);
+
+        budget -= bytes;
+        upload_flushed_bytes += bytes;
+
+        // if the copy did not fit in the budget, keep the rest
+        if(bytes < queue[first].bytes) {
+            queue[first].dst   += bytes;
+            queue[first].src   += bytes;
+            queue[first].bytes -= bytes;
+        } else {
+            first = (first + 1) % UPLOAD_QUEUE_SIZE;
+            count--;
+        }
+    }
+    upload_queue_depth = count;
+}
@@ -0,0 +1,170 @@
+/* Copyright 2025 Vulcalien
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "vram.h"
+
+#include "upload.h"
+
+#define RESIDENT_LIMIT 32
+
+static struct {
+    const void *src; // NULL if the entry is unused
+    u16 first_tile;
+    u16 tiles;
+
+    u16 refs;
+} resident[RESIDENT_LIMIT];
+
+static u32 upload_count;
+static u8 uploads[RESIDENT_LIMIT]; // indexes of 'resident'
+
+static inline bool overlaps(u32 i, u32 first_tile, u32 tiles) {
+    return resident[i].first_tile < first_tile + tiles &&
+           first_tile < resident[i].first_tile + resident[i].tiles;
+}
+
+// Returns the first tile of a free range, or -1 if there is none. If
+// 'evict' is true, assets that are not in use count as free.
+static i32 find_range(u32 tiles, bool evict) {
+    // candidates are the first tile and the tiles after each asset
+    for(i32 c = -1; c < RESIDENT_LIMIT; c++) {
+        u32 first_tile;
+        if(c < 0) {
+            first_tile = VRAM_FIRST_TILE;
+        } else {
+            if(!resident[c].src)
+                continue;
+            first_tile = resident[c].first_tile + resident[c].tiles;
+        }
+
+        if(first_tile + tiles > VRAM_LAST_TILE + 1)
+            continue;
+
+        bool free = true;
+        for(u32 i = 0; i < RESIDENT_LIMIT; i++) {
+            if(!resident[i].src)
+                continue;
+            if(evict && resident[i].refs == 0)
+                continue;
+
+            if(overlaps(i, first_tile, tiles)) {
+                free = false;
+                break;
+            }
+        }
+        if(free)
+            return first_tile;
+    }
+    return -1;
+}
+
+static void cancel_upload(u32 entry) {
+    for(u32 i = 0; i < upload_count; i++) {
+        if(uploads[i] == entry) {
+            uploads[i] = uploads[--upload_count];
+            break;
+        }
+    }
+}
+
+// Returns a free entry of 'resident', or -1 if there is none. If all
+// entries are used, an asset that is not in use is evicted.
+static i32 find_entry(void) {
+    for(u32 i = 0; i < RESIDENT_LIMIT; i++)
+        if(!resident[i].src)
+            return i;
+
+    for(u32 i = 0; i < RESIDENT_LIMIT; i++) {
+        if(resident[i].refs == 0) {
+            resident[i].src = NULL;
+            cancel_upload(i);
+            return i;
+        }
+    }
+    return -1;
+}
+
+u16 vram_acquire(const void *src, u32 tiles) {
+    // check if the asset is already resident
+    for(u32 i = 0; i < RESIDENT_LIMIT; i++) {
+        if(resident[i].src == src) {
+            resident[i].refs++;
+            return resident[i].first_tile;
+        }
+    }
+
+    const i32 entry = find_entry();
+    if(entry < 0)
+        return VRAM_NO_TILE;
+
+    // prefer ranges that do not evict other assets
+    i32 first_tile = find_range(tiles, false);
+    if(first_tile < 0) {
+        first_tile = find_range(tiles, true);
+        if(first_tile < 0)
+            return VRAM_NO_TILE;
+
+        // evict unused assets in the chosen range
+        for(u32 i = 0; i < RESIDENT_LIMIT; i++) {
+            if(resident[i].src && overlaps(i, first_tile, tiles)) {
+                resident[i].src = NULL;
+                cancel_upload(i);
+            }
+        }
+    }
+
+    // add the asset to the resident list
+    resident[entry].src = src;
+    resident[entry].first_tile = first_tile;
+    resident[entry].tiles = tiles;
+    resident[entry].refs = 1;
+
+    uploads[upload_count++] = entry;
+    return first_tile;
+}
+
+void vram_release(const void *src) {
+    if(!src)
+        return;
+
+    for(u32 i = 0; i < RESIDENT_LIMIT; i++) {
+        if(resident[i].src == src) {
+            if(resident[i].refs > 0)
+                resident[i].refs--;
+            break;
+        }
+    }
+}
+
+void vram_update(void) {
+    u32 posted = 0;
+    for(; posted < upload_count; posted++) {
+        const u32 entry = uploads[posted];
+
+        const bool queued = upload_post(
+            (vu8 *) display_charblock(4) + resident[entry].first_tile * 32,
+            resident[entry].src,
+            resident[entry].tiles * 32,
+            DMA_CHUNK_32_BIT
+        );
+        if(!queued)
+            break;
+    }
+
+    // keep the uploads that did not fit in the queue
+    for(u32 i = posted; i < upload_count; i++)
+        uploads[i - posted] = uploads[i];
+    upload_count -= posted;
+}